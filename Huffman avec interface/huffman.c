@@ -2,30 +2,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
+#include "../commun/bloc.h"
+#include "../commun/crc32c.h"
+#include "../commun/memoire.h"
+#include "../commun/pipeline.h"
+#include "huffman_kernels.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 #include <sys/stat.h> // pour les stats de compression
 
-/**
- * Struct : MinHeapNode* newNode
- * Description : Crée un nouveau nœud pour l'arbre de Huffman, avec un caractère et une fréquence spécifiés.
- *               Ce nœud peut être utilisé dans un tas binaire (min-heap) pour construire l'arbre de Huffman.
- * Paramètres :
- * - char data : Le caractère associé au nœud. Il représente un caractère de l'entrée à encoder.
- * - unsigned freq : La fréquence d'apparition de ce caractère. Cette valeur est utilisée pour construire l'arbre de Huffman.
- * Retour :
- * - struct MinHeapNode* : Un pointeur vers le nouveau nœud alloué dynamiquement.
- *                         Si l'allocation échoue, la fonction retourne NULL.
- */
-struct MinHeapNode* newNode(char data, unsigned freq) {
-    struct MinHeapNode* node = malloc(sizeof(struct MinHeapNode));
-    node->data = data;
-    node->freq = freq;
-    node->left = node->right = NULL;
-    return node;
-}
-
-
-
 /**
  * Fonction : swap
  * Description : Échange deux nœuds dans le tas pour maintenir la propriété de l'arbre binaire
@@ -121,164 +110,531 @@ void insertMinHeap(struct MinHeapNode* minHeap[], int* size, struct MinHeapNode*
 }
 
 
+/* Arbre de Huffman construit sans allocation : les nœuds sont pris dans un tableau, dans l'ordre
+ * de leur création, et les codes sont rangés par octet plutôt qu'en chaînes de caractères */
+struct CodeTree {
+    struct MinHeapNode nodes[2 * MAX_CHAR - 1];
+    struct MinHeapNode* root;        // NULL pour une table vide
+    unsigned char lengths[MAX_CHAR]; // Profondeur de chaque feuille (0 pour un octet absent)
+    uint32_t codes[MAX_CHAR];        // Chemin de chaque feuille, aligné à droite (significatif jusqu'à 32 bits)
+};
+
 /**
- * Fonction : buildHuffmanTree
- * Description : Construit l'arbre de Huffman à partir d'un tableau de fréquences de caractères 
- *               et génère les codes binaires correspondants pour chaque caractère.
+ * Fonction : buildCodeTree
+ * Description : Construit l'arbre de Huffman dans tree->nodes en fusionnant, tant qu'il en reste
+ *               plusieurs, les deux nœuds de plus petite fréquence du tas (dans l'ordre de l'ancien
+ *               encodeur, dont les fichiers sont décodés avec cet arbre), puis calcule la longueur
+ *               et le code de chaque octet. Un parent
+ *               étant créé après ses fils, un parcours des nœuds du dernier (la racine) au premier
+ *               donne les profondeurs sans récursion. Rien n'est alloué ni à libérer.
  * Paramètres :
- * - int freq[] : Tableau contenant les fréquences des caractères (indexé par leur valeur ASCII).
- * - char codes[MAX_CHAR][MAX_CHAR] : Tableau pour stocker les codes binaires générés pour chaque caractère.
- * Étapes :
- * 1. Crée un nœud pour chaque caractère ayant une fréquence non nulle et l'insère dans un min-heap.
- * 2. Fusionne les deux nœuds ayant les plus petites fréquences jusqu'à ce qu'un seul nœud reste (racine de l'arbre de Huffman).
- * 3. Parcourt l'arbre de Huffman pour générer les codes binaires pour chaque caractère.
+ * - const int freq[MAX_CHAR] : Table des fréquences.
+ * - struct CodeTree* tree : Reçoit l'arbre, les longueurs et les codes.
  */
-
-void buildHuffmanTree(int freq[], char codes[MAX_CHAR][MAX_CHAR]) {
+static void buildCodeTree(const int freq[MAX_CHAR], struct CodeTree* tree) {
     struct MinHeapNode* minHeap[MAX_CHAR];
-    int size = 0;
+    int size = 0, count = 0;
 
-    // Étape 1 : Création des nœuds pour les caractères ayant une fréquence non nulle
     for (int i = 0; i < MAX_CHAR; i++) {
         if (freq[i]) {
-            insertMinHeap(minHeap, &size, newNode((char)i, freq[i]));
+            struct MinHeapNode* node = &tree->nodes[count++];
+            *node = (struct MinHeapNode){ (char)i, (unsigned)freq[i], NULL, NULL };
+            insertMinHeap(minHeap, &size, node);
         }
     }
-
-    // Étape 2 : Construction de l'arbre de Huffman
     while (size > 1) {
-        // Extraire les deux nœuds ayant les fréquences minimales
         struct MinHeapNode* left = extractMin(minHeap, &size);
         struct MinHeapNode* right = extractMin(minHeap, &size);
-        // Crée un nouveau nœud avec la somme des fréquences des deux nœuds extraits
-        struct MinHeapNode* top = newNode('$', left->freq + right->freq); 
-        top->left = left;
-        top->right = right;
-        // Insère le nouveau nœud dans le min-heap
+        struct MinHeapNode* top = &tree->nodes[count++];
+        *top = (struct MinHeapNode){ '$', left->freq + right->freq, left, right };
         insertMinHeap(minHeap, &size, top);
     }
+    tree->root = size ? minHeap[0] : NULL;
+
+    // Profondeur et chemin de chaque nœud, de la racine (créée en dernier) vers les feuilles
+    unsigned char depth[2 * MAX_CHAR - 1];
+    uint32_t path[2 * MAX_CHAR - 1];
+    memset(tree->lengths, 0, sizeof(tree->lengths));
+    memset(tree->codes, 0, sizeof(tree->codes));
+    if (count > 0) {
+        depth[count - 1] = 0;
+        path[count - 1] = 0;
+    }
+    for (int k = count - 1; k >= 0; k--) {
+        struct MinHeapNode* node = &tree->nodes[k];
+        if (node->left) {
+            int left = (int)(node->left - tree->nodes), right = (int)(node->right - tree->nodes);
+            depth[left] = depth[right] = (unsigned char)(depth[k] + 1);
+            path[left] = path[k] << 1;
+            path[right] = path[k] << 1 | 1;
+        } else {
+            tree->lengths[(unsigned char)node->data] = depth[k];
+            tree->codes[(unsigned char)node->data] = path[k];
+        }
+    }
+}
 
-     // Étape 3 : Génération des codes binaires à partir de l'arbre de Huffman
-    char temp[MAX_CHAR]; // Tableau temporaire pour stocker le chemin actuel
-    int top = 0; // Indice pour gérer le tableau temporaire
-    struct MinHeapNode* root = minHeap[0]; // Racine de l'arbre de Huffman
+// a ce stade nous avons nos structure de noeud et nos fonctions pour les manipuler. En creer, en rajouter a la pile, changer leurs positions.
+// Nous avons aussi la fonction pour creer l'arbre et generer les codes correspondants
 
-    // Fonction auxiliaire pour parcourir l'arbre et stocker les codes
-    void storeCodes(struct MinHeapNode* node) {
-        if (!node) return;
+/**
+ * Fonction : computeCodeLengths
+ * Description : Calcule la longueur du code de chaque octet à partir de l'arbre de Huffman, puis
+ *               ramène les longueurs à maxCodeLength au plus : les codes trop longs sont tronqués,
+ *               l'inégalité de Kraft est rétablie en allongeant les codes les plus longs (les moins
+ *               fréquents d'abord), puis la place libérée est rendue aux codes les plus fréquents.
+ *               Le calcul est déterministe, le décodeur le refait à l'identique à partir de la table.
+ * Paramètres :
+ * - int freq[MAX_CHAR] : Table des fréquences, avec au moins deux symboles.
+ * - int maxCodeLength : Limite, entre HUFFMAN_MIN_CODE_LENGTH et HUFFMAN_MAX_CODE_LENGTH.
+ * - unsigned char lengths[MAX_CHAR] : Reçoit les longueurs (0 pour un octet absent).
+ * Retour :
+ * - int : La plus grande longueur obtenue.
+ */
+static int computeCodeLengths(int freq[MAX_CHAR], int maxCodeLength, unsigned char lengths[MAX_CHAR]) {
+    struct CodeTree tree;
+    buildCodeTree(freq, &tree);
 
-        // Ajouter '0' au chemin actuel pour descendre à gauche
-        if (node->left) {
-            temp[top++] = '0';
-            storeCodes(node->left);
-            top--; // backtrack
+    int maxLength = 0;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        lengths[i] = tree.lengths[i];
+        if (lengths[i] > maxLength) {
+            maxLength = lengths[i];
         }
+    }
+    if (maxLength <= maxCodeLength) {
+        return maxLength;
+    }
 
-        // Ajouter '1' au chemin actuel pour descendre à droite
-        if (node->right) {
-            temp[top++] = '1';
-            storeCodes(node->right);
-            top--; // backtrack
+    // Somme de Kraft en unités de 2^-maxCodeLength : le code est valide tant qu'elle ne dépasse pas capacity
+    const uint32_t capacity = 1u << maxCodeLength;
+    uint32_t kraft = 0;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        if (lengths[i] > maxCodeLength) {
+            lengths[i] = (unsigned char)maxCodeLength;
+        }
+        if (lengths[i]) {
+            kraft += 1u << (maxCodeLength - lengths[i]);
         }
+    }
 
-        // Si un nœud feuille est atteint, le code est complet
-        if (!node->left && !node->right) {
-            temp[top] = '\0'; // Terminer la chaîne de caractères
-            strcpy(codes[(unsigned char)node->data], temp); // Stocker le code dans le tableau
+    // Allongement : il reste toujours un code allongeable, 256 codes de maxCodeLength bits tiennent
+    while (kraft > capacity) {
+        int best = -1;
+        for (int i = 0; i < MAX_CHAR; i++) {
+            if (lengths[i] && lengths[i] < maxCodeLength &&
+                (best < 0 || lengths[i] > lengths[best] ||
+                 (lengths[i] == lengths[best] && freq[i] < freq[best]))) {
+                best = i;
+            }
         }
+        kraft -= 1u << (maxCodeLength - lengths[best] - 1);
+        lengths[best]++;
     }
 
-    // Lancer le parcours de l'arbre à partir de la racine
-    storeCodes(root);
+    // Raccourcissement, des octets les plus fréquents aux moins fréquents (tri stable)
+    int order[MAX_CHAR];
+    int count = 0;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        if (lengths[i]) {
+            int j = count++;
+            while (j > 0 && freq[order[j - 1]] < freq[i]) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = i;
+        }
+    }
+    for (int changed = 1; changed; ) {
+        changed = 0;
+        for (int j = 0; j < count; j++) {
+            int s = order[j];
+            if (lengths[s] > 1 && kraft + (1u << (maxCodeLength - lengths[s])) <= capacity) {
+                kraft += 1u << (maxCodeLength - lengths[s]);
+                lengths[s]--;
+                changed = 1;
+            }
+        }
+    }
+
+    maxLength = 0;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        if (lengths[i] > maxLength) {
+            maxLength = lengths[i];
+        }
+    }
+    return maxLength;
 }
 
-// a ce stade nous avons nos structure de noeud et nos fonctions pour les manipuler. En creer, en rajouter a la pile, changer leurs positions.
-// Nous avons aussi la fonction pour creer l'arbre et generer les codes correspondants
+/**
+ * Fonction : canonicalCodes
+ * Description : Attribue les codes canoniques : par longueur croissante puis par valeur d'octet,
+ *               chaque code suit le précédent. Les codes ne dépendent ainsi que des longueurs.
+ * Paramètres :
+ * - const unsigned char lengths[MAX_CHAR] : Longueurs des codes (au plus HUFFMAN_MAX_CODE_LENGTH).
+ * - uint32_t codes[MAX_CHAR] : Reçoit les codes, alignés à droite.
+ */
+static void canonicalCodes(const unsigned char lengths[MAX_CHAR], uint32_t codes[MAX_CHAR]) {
+    uint32_t count[HUFFMAN_MAX_CODE_LENGTH + 1] = {0};
+    uint32_t next[HUFFMAN_MAX_CODE_LENGTH + 1];
+    for (int i = 0; i < MAX_CHAR; i++) {
+        count[lengths[i]]++;
+    }
+    count[0] = 0;
+    uint32_t code = 0;
+    for (int length = 1; length <= HUFFMAN_MAX_CODE_LENGTH; length++) {
+        code = (code + count[length - 1]) << 1;
+        next[length] = code;
+    }
+    for (int i = 0; i < MAX_CHAR; i++) {
+        codes[i] = lengths[i] ? next[lengths[i]]++ : 0;
+    }
+}
+
+// Taille allouée par compressBlockWith pour un bloc de size octets : chaque flux a sa zone (ses
+// symboles au pire, plus la marge de 8 octets des noyaux)
+static size_t compressedAllocation(uint32_t size, int streams, int maxLength, size_t* zoneSize) {
+    *zoneSize = ((size_t)(size / streams + 1) * maxLength + 7) / 8 + 8;
+    return sizeof(struct EnTeteBloc) + MAX_CHAR * sizeof(int) + sizeof(struct HuffmanStreams) + streams * *zoneSize;
+}
 
 /**
- * Fonction : compressFile
- * Description : Compresse un fichier texte en utilisant l'algorithme de Huffman. 
- *               Le fichier compressé contient la table des fréquences suivie des données compressées.
+ * Fonction : compressBlockWith
+ * Description : Compresse un bloc d'octets en mémoire au format HUF3. Chaque bloc porte sa propre
+ *               table des fréquences, ce qui le rend décodable indépendamment des autres.
+ *               Les longueurs de codes sont limitées à maxCodeLength et les codes sont canoniques ;
+ *               les octets sont répartis sur streams flux entrelacés. L'encodage passe par le noyau
+ *               spécialisé pour la longueur maximale obtenue et le nombre de flux.
+ *               Le CRC32C des données est calculé pendant le comptage des fréquences, tranche
+ *               par tranche, tant que chaque tranche est encore dans le cache.
  * Paramètres :
- * - const char* inputFile : Nom du fichier d'entrée à compresser.
- * - const char* outputFile : Nom du fichier de sortie pour stocker les données compressées.
+ * - const unsigned char* input : Octets à compresser.
+ * - uint32_t size : Nombre d'octets (au moins 1).
+ * - int streams : Nombre de flux entrelacés (1, 2 ou 4).
+ * - int maxCodeLength : Longueur maximale des codes (HUFFMAN_MIN_CODE_LENGTH à HUFFMAN_MAX_CODE_LENGTH).
+ * - size_t* blockSize : Reçoit la taille totale du bloc produit (en-tête compris).
+ * Retour :
+ * - unsigned char* : Bloc alloué dynamiquement (en-tête, table des fréquences, description des flux,
+ *                    flux compressés), à libérer avec memoire_liberer. NULL si l'allocation échoue ou si les
+ *                    paramètres sont invalides.
  */
-void compressFile(const char* inputFile, const char* outputFile) {
-    FILE *inFile = fopen(inputFile, "r");  // Ouverture du fichier d'entrée en mode lecture
-    if (!inFile) {
-        perror("Ne peut pas ouvrir le fichier");
-        return;
+unsigned char* compressBlockWith(const unsigned char* input, uint32_t size, int streams, int maxCodeLength,
+                                size_t* blockSize) {
+    if ((streams != 1 && streams != 2 && streams != 4) ||
+        maxCodeLength < HUFFMAN_MIN_CODE_LENGTH || maxCodeLength > HUFFMAN_MAX_CODE_LENGTH) {
+        fprintf(stderr, "Paramètres de compression invalides : %d flux, codes de %d bits\n", streams, maxCodeLength);
+        return NULL;
     }
 
     int freq[MAX_CHAR] = {0};
-    char caractere_lu;
-
-    // Étape 1 : Analyser le fichier pour calculer la fréquence d'apparition de chaque caractère
-    while ((caractere_lu = fgetc(inFile)) != EOF) {
-        freq[(unsigned char)caractere_lu]++;
+    uint32_t dataCrc = CRC32C_INIT;
+
+    // Étape 1 : Comptage des fréquences et CRC des données, par tranches chaudes dans le cache
+    for (uint32_t start = 0; start < size; start += CRC32C_TRANCHE) {
+        uint32_t end = size - start < CRC32C_TRANCHE ? size : start + CRC32C_TRANCHE;
+        dataCrc = crc32c_maj(dataCrc, input + start, end - start);
+        for (uint32_t i = start; i < end; i++) {
+            freq[input[i]]++;
+        }
     }
-    fclose(inFile);
 
-    // Print de debug
-    printf("Frequence caracteres:\n");
+    // Étape 2 : Longueurs limitées puis codes canoniques (un seul symbole : aucun bit à écrire)
+    int symbols = 0;
     for (int i = 0; i < MAX_CHAR; i++) {
-        if (freq[i] > 0) {
-            printf("Character: '%c' Frequence: %d\n", (char)i, freq[i]);
+        symbols += freq[i] > 0;
+    }
+    unsigned char lengths[MAX_CHAR] = {0};
+    uint32_t codes[MAX_CHAR];
+    int maxLength = symbols > 1 ? computeCodeLengths(freq, maxCodeLength, lengths) : 0;
+    canonicalCodes(lengths, codes);
+
+    struct HuffmanStreams streamInfo = {0};
+    streamInfo.count = (uint8_t)streams;
+    streamInfo.maxCodeLength = (uint8_t)maxCodeLength;
+
+    // Chaque flux est d'abord écrit dans sa propre zone, puis les zones sont rapprochées
+    size_t zoneSize;
+    size_t prefixSize = sizeof(struct EnTeteBloc) + sizeof(freq) + sizeof(streamInfo);
+    unsigned char* block = memoire_allouer(compressedAllocation(size, streams, maxLength, &zoneSize));
+    if (!block) {
+        return NULL;
+    }
+    unsigned char* payload = block + prefixSize;
+
+    // Étape 3 : Encodage par le noyau spécialisé
+    size_t payloadSize = 0;
+    if (maxLength > 0) {
+        struct BitWriter writers[HUFFMAN_MAX_STREAMS];
+        for (int k = 0; k < streams; k++) {
+            writers[k].out = payload + k * zoneSize;
+            writers[k].acc = 0;
+            writers[k].bits = 0;
+        }
+        encodeKernels[kernelLengthClass(maxLength)][kernelStreamClass(streams)](input, size, codes, lengths, writers);
+
+        for (int k = 0; k < streams; k++) {
+            streamInfo.sizes[k] = (uint32_t)(writers[k].out - (payload + k * zoneSize));
+            memmove(payload + payloadSize, payload + k * zoneSize, streamInfo.sizes[k]);
+            payloadSize += streamInfo.sizes[k];
         }
     }
 
-    // Étape 2 : Construire l'arbre de Huffman à partir des fréquences et générer les codes binaires pour chaque caractère
-    char codes[MAX_CHAR][MAX_CHAR] = {0};
-    buildHuffmanTree(freq, codes);
+    struct EnTeteBloc header;
+    header.taille_originale = size;
+    header.taille_compressee = (uint32_t)(sizeof(freq) + sizeof(streamInfo) + payloadSize);
+    header.crc_donnees = dataCrc;
+
+    unsigned char* body = block + sizeof(header);
+    memcpy(body, freq, sizeof(freq));
+    memcpy(body + sizeof(freq), &streamInfo, sizeof(streamInfo));
+    header.crc_bloc = calculer_crc_bloc(&header, body);
+    memcpy(block, &header, sizeof(header));
+    *blockSize = sizeof(header) + header.taille_compressee;
+    return block;
+}
 
-    // Print des codes Huffman pour debug
-    printf("Codes Huffman:\n");
-    for (int i = 0; i < MAX_CHAR; i++) {
-        if (freq[i] > 0) {
-            printf("Character: '%c' Code: %s\n", (char)i, codes[i]);
+/**
+ * Fonction : compressBlock
+ * Description : Compresse un bloc avec les réglages par défaut (HUFFMAN_STREAMS flux,
+ *               codes d'au plus HUFFMAN_CODE_LENGTH bits), voir compressBlockWith.
+ */
+unsigned char* compressBlock(const unsigned char* input, uint32_t size, size_t* blockSize) {
+    return compressBlockWith(input, size, HUFFMAN_STREAMS, HUFFMAN_CODE_LENGTH, blockSize);
+}
+
+/**
+ * Fonction : compressStream
+ * Description : Compresse un flux déjà ouvert vers un autre flux, au format HUF3 : le nombre
+ *               magique puis une suite de blocs de HUFFMAN_BLOCK_SIZE octets au plus (voir
+ *               compressBlock : HUFFMAN_STREAMS flux entrelacés, codes canoniques d'au plus
+ *               HUFFMAN_CODE_LENGTH bits), chacun protégé par deux CRC32C, et un en-tête de bloc
+ *               vide pour marquer la fin.
+ * Paramètres :
+ * - FILE* inFile : Flux à compresser.
+ * - FILE* outFile : Flux où les données compressées sont écrites.
+ * - unsigned long long* originalSize : Reçoit le nombre d'octets lus (peut être NULL).
+ * - ProgressCallback progress : Appelée après chaque bloc avec le nombre d'octets lus (peut être NULL).
+ * - void* userData : Transmis tel quel à progress.
+ * Retour :
+ * - int : 0 en cas de succès, -1 si la mémoire manque ou si progress a demandé l'annulation.
+ */
+int compressStream(FILE* inFile, FILE* outFile, unsigned long long* originalSize,
+                   ProgressCallback progress, void* userData) {
+    unsigned char* input = memoire_allouer(HUFFMAN_BLOCK_SIZE);
+    if (!input) {
+        perror("Ne peut pas allouer le bloc d'entrée");
+        return -1;
+    }
+
+    fwrite(HUFFMAN_MAGIC, 1, TAILLE_MAGIQUE, outFile);
+
+    // Lecture et compression bloc par bloc
+    size_t readSize;
+    unsigned long long totalRead = 0;
+    int result = 0;
+    while ((readSize = fread(input, 1, HUFFMAN_BLOCK_SIZE, inFile)) > 0) {
+        size_t blockSize;
+        unsigned char* block = compressBlock(input, (uint32_t)readSize, &blockSize);
+        if (!block) {
+            perror("Ne peut pas allouer le bloc compressé");
+            result = -1;
+            break;
+        }
+        fwrite(block, 1, blockSize, outFile);
+        memoire_liberer(block);
+        totalRead += readSize;
+        if (progress && progress(totalRead, userData) != 0) {
+            fprintf(stderr, "Compression annulée\n");
+            result = -1;
+            break;
         }
     }
 
-    // Ouverture du fichier de sortie en mode binaire
-    FILE *outFile = fopen(outputFile, "wb");
-    if (!outFile) {
+    // Marqueur de fin
+    struct EnTeteBloc end = {0};
+    fwrite(&end, sizeof(end), 1, outFile);
+
+    memoire_liberer(input);
+    if (originalSize) {
+        *originalSize = totalRead;
+    }
+    return result;
+}
+
+// Réglages de chaque niveau, du plus rapide (1) au plus compact (9) : la longueur maximale des
+// codes fixe la taille de la table de décodage (11 bits : 4 Ko), et des blocs plus grands portent
+// moins de tables des fréquences
+static const struct {
+    uint32_t blockSize;
+    int maxCodeLength;
+} huffmanLevels[9] = {
+    { 1 << 18, 11 }, { 1 << 19, 11 }, { 1 << 20, 11 },
+    { 1 << 18, 12 }, { 1 << 19, 12 }, { 1 << 20, 12 },
+    { 1 << 18, 15 }, { 1 << 19, 15 }, { 1 << 20, 15 },
+};
+
+/**
+ * Fonction : huffmanLevelOptions
+ * Description : Remplit les options de compression d'un niveau (1 à 9, bornés), pour tous les cœurs.
+ *               Le niveau HUFFMAN_LEVEL correspond aux réglages de compressBlock.
+ * Paramètres :
+ * - int level : Niveau demandé.
+ * - struct HuffmanOptions* options : Options à remplir.
+ */
+void huffmanLevelOptions(int level, struct HuffmanOptions* options) {
+    level = level < 1 ? 1 : level > 9 ? 9 : level;
+    options->blockSize = huffmanLevels[level - 1].blockSize;
+    options->streams = HUFFMAN_STREAMS;
+    options->maxCodeLength = huffmanLevels[level - 1].maxCodeLength;
+    options->threads = 0;
+    options->depth = 0;
+}
+
+/**
+ * Fonction : huffmanLowMemoryOptions
+ * Description : Remplit les options du mode économe en mémoire, pour les petites cibles : blocs de
+ *               HUFFMAN_LOW_MEMORY_BLOCK_SIZE octets, codes d'au plus 11 bits (table de décodage de
+ *               4 Ko sur la pile), un seul travailleur et deux blocs en mémoire. La mémoire de travail
+ *               est alors bornée par huffmanCompressMemoryBound et huffmanDecompressMemoryBound.
+ * Paramètres :
+ * - struct HuffmanOptions* options : Options à remplir, valables en compression comme en décompression.
+ */
+void huffmanLowMemoryOptions(struct HuffmanOptions* options) {
+    options->blockSize = HUFFMAN_LOW_MEMORY_BLOCK_SIZE;
+    options->streams = HUFFMAN_STREAMS;
+    options->maxCodeLength = 11;
+    options->threads = 1;
+    options->depth = 2;
+}
+
+// Options de fichier valides : taille de bloc et longueur des codes dans les limites du format
+static int checkOptions(const struct HuffmanOptions* options) {
+    if (options->blockSize == 0 || options->blockSize > HUFFMAN_BLOCK_SIZE) {
+        fprintf(stderr, "Taille de bloc invalide : %u octets (au plus %d)\n", options->blockSize, HUFFMAN_BLOCK_SIZE);
+        return -1;
+    }
+    if (options->maxCodeLength < HUFFMAN_MIN_CODE_LENGTH || options->maxCodeLength > HUFFMAN_MAX_CODE_LENGTH) {
+        fprintf(stderr, "Longueur de code invalide : %d bits\n", options->maxCodeLength);
+        return -1;
+    }
+    return 0;
+}
+
+// Paramètres du pipeline de compression (sans le traitement)
+static void compressParams(const struct HuffmanOptions* options, struct ParametresPipeline* params) {
+    *params = (struct ParametresPipeline){0};
+    params->decoupage = DECOUPAGE_TRANCHES;
+    params->taille_tranche = options->blockSize;
+    params->nb_travailleurs = options->threads;
+    params->profondeur = options->depth;
+}
+
+/**
+ * Fonction : huffmanCompressMemoryBound
+ * Description : Borne la mémoire de travail de compressFileWith avec ces options (telle que mesurée
+ *               dans StatistiquesPipeline.memoire_pic) : le pipeline, ses blocs et leur sortie au
+ *               pire. L'arbre, les codes et les noyaux n'utilisent que la pile.
+ * Paramètres :
+ * - const struct HuffmanOptions* options : Options de compression.
+ * Retour :
+ * - size_t : La borne, en octets.
+ */
+size_t huffmanCompressMemoryBound(const struct HuffmanOptions* options) {
+    struct ParametresPipeline params;
+    size_t zoneSize;
+    compressParams(options, &params);
+    return borne_memoire_pipeline(&params, compressedAllocation(options->blockSize, options->streams,
+                                                                options->maxCodeLength, &zoneSize), 0);
+}
+
+// Traitement d'une tranche par un travailleur du pipeline, avec les options du fichier
+static unsigned char* compressTask(const unsigned char* input, size_t size, size_t* outSize, void* context) {
+    const struct HuffmanOptions* options = context;
+    unsigned char* block = compressBlockWith(input, (uint32_t)size, options->streams, options->maxCodeLength, outSize);
+    if (!block) {
+        fprintf(stderr, "Ne peut pas allouer le bloc compressé\n");
+    }
+    return block;
+}
+
+/**
+ * Fonction : compressFileWith
+ * Description : Compresse un fichier au format HUF3 avec les options données. La lecture, la
+ *               compression des blocs et l'écriture se recouvrent (voir executer_pipeline).
+ * Paramètres :
+ * - const char* inputFile : Nom du fichier d'entrée à compresser, éventuellement un tube (lu dans l'ordre).
+ * - const char* outputFile : Nom du fichier de sortie pour stocker les données compressées (pas un tube).
+ * - const struct HuffmanOptions* options : Taille des blocs (au plus HUFFMAN_BLOCK_SIZE), flux,
+ *   longueur maximale des codes, nombre de travailleurs et profondeur du pipeline (voir
+ *   huffmanLevelOptions et huffmanLowMemoryOptions).
+ * - struct StatistiquesPipeline* stats : Reçoit les mesures du pipeline (peut être NULL).
+ * Retour :
+ * - int : 0 en cas de succès, -1 en cas d'erreur (message déjà affiché).
+ */
+int compressFileWith(const char* inputFile, const char* outputFile, const struct HuffmanOptions* options,
+                     struct StatistiquesPipeline* stats) {
+    if (checkOptions(options) != 0) {
+        return -1;
+    }
+
+    int inFd = open(inputFile, O_RDONLY);  // Ouverture du fichier d'entrée en mode lecture
+    if (inFd < 0) {
         perror("Ne peut pas ouvrir le fichier");
-        return;
+        return -1;
     }
 
+    // Ouverture du fichier de sortie
+    int outFd = open(outputFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outFd < 0) {
+        perror("Ne peut pas ouvrir le fichier");
+        close(inFd);
+        return -1;
+    }
 
-    // Écriture de la table des fréquences dans le fichier de sortie
-    fwrite(freq, sizeof(int), MAX_CHAR, outFile);
-
-    // Réouverture du fichier d'entrée pour encoder son contenu
-    inFile = fopen(inputFile, "r");
-    unsigned char buffer = 0; // Buffer pour stocker les bits
-    int bitCount = 0; // Compte le nombre de bits dans le buffer
-    unsigned long totalBitsWritten = 0; // Suit le total bits ecrits
-
-    // Étape 3 : Encoder le contenu du fichier en utilisant les codes de Huffman et écrire les bits compressés dans le fichier de sortie
-    //Encodage en utilisant le buffer
-    while ((caractere_lu = fgetc(inFile)) != EOF) {
-        char* code = codes[(unsigned char)caractere_lu];
-        for (int i = 0; code[i]; i++) {
-            buffer = (buffer << 1) | (code[i] - '0'); // Ajouter un bit au buffer
-            bitCount++;
-            totalBitsWritten++;
-            if (bitCount == 8) { // Si le buffer est plein, écrire un octet
-                fputc(buffer, outFile);
-                buffer = 0;
-                bitCount = 0;
-            }
+    // Nombre magique, blocs écrits par le pipeline, puis marqueur de fin
+    struct ParametresPipeline params;
+    compressParams(options, &params);
+    params.traitement = compressTask;
+    params.contexte = (void*)options;
+    struct StatistiquesPipeline measures;
+    struct EnTeteBloc end = {0};
+
+    int result = -1;
+    if (pwrite(outFd, HUFFMAN_MAGIC, TAILLE_MAGIQUE, 0) != TAILLE_MAGIQUE) {
+        perror("Erreur d'écriture");
+    } else if (executer_pipeline(inFd, 0, outFd, TAILLE_MAGIQUE, &params, &measures) == 0) {
+        if (pwrite(outFd, &end, sizeof(end), TAILLE_MAGIQUE + measures.octets_ecrits) != sizeof(end)) {
+            perror("Erreur d'écriture");
+        } else {
+            result = 0;
         }
     }
 
-    // Finaliser l'écriture du fichier compressé en ajoutant les bits restants dans le buffer
-    // Gestion des bits restant pour eviter certains problemes en fin de fichier
-    if (bitCount > 0) {
-        buffer <<= (8 - bitCount); // Compléter avec des zéros
-        fputc(buffer, outFile);
+    close(inFd);
+    close(outFd);
+    if (result != 0) {
+        fprintf(stderr, "Échec de la compression de %s\n", inputFile);
+    } else if (stats) {
+        *stats = measures;
     }
+    return result;
+}
 
+/**
+ * Fonction : compressFile
+ * Description : Compresse un fichier en utilisant l'algorithme de Huffman, au niveau HUFFMAN_LEVEL
+ *               (voir compressFileWith), et affiche le résumé.
+ * Paramètres :
+ * - const char* inputFile : Nom du fichier d'entrée à compresser.
+ * - const char* outputFile : Nom du fichier de sortie pour stocker les données compressées.
+ */
+void compressFile(const char* inputFile, const char* outputFile) {
+    struct HuffmanOptions options;
+    struct StatistiquesPipeline stats;
+    huffmanLevelOptions(HUFFMAN_LEVEL, &options);
+    if (compressFileWith(inputFile, outputFile, &options, &stats) != 0) {
+        return;
+    }
 
     // print de debug pour le benchmark
     long originalSize = getFileSize(inputFile);
@@ -289,69 +645,359 @@ void compressFile(const char* inputFile, const char* outputFile) {
         printf("Taille compressée : %ld octets\n", compressedSize);
         printf("Taux de compression : %.2f\n", compressionRatio);
     }
+    printf("CRC32C : %s\n", crc32c_implementation());
+    afficher_statistiques_pipeline(&stats);
+}
 
-    fclose(inFile);
-    fclose(outFile);
 
+/**
+ * Fonction : checkFrequencies
+ * Description : Valide une table des fréquences lue dans un fichier non fiable.
+ * Paramètres :
+ * - const int freq[MAX_CHAR] : Table lue.
+ * - unsigned long long* total : Reçoit la somme des fréquences (le nombre de symboles à décoder).
+ * Retour :
+ * - int : Le nombre de symboles distincts, ou -1 si une fréquence est négative.
+ */
+static int checkFrequencies(const int freq[MAX_CHAR], unsigned long long* total) {
+    int symbols = 0;
+    *total = 0;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        if (freq[i] < 0) {
+            return -1;
+        }
+        if (freq[i] > 0) {
+            symbols++;
+            *total += (unsigned)freq[i];
+        }
+    }
+    return symbols;
+}
 
-    // Afficher le total de bits écrits pour validation
-    printf("Total bits ecrits: %lu\n", totalBitsWritten);
+/**
+ * Fonction : buildDecodeTable
+ * Description : Construit la table de décodage d'un code préfixe : l'entrée indexée par les
+ *               tableBits prochains bits vaut (octet << 8) | longueur du code qui les commence.
+ *               Les motifs qui ne commencent aucun code (code incomplet) consomment tableBits
+ *               bits : un flux qui les contient échoue au contrôle de taille ou de CRC.
+ * Paramètres :
+ * - const unsigned char lengths[MAX_CHAR], const uint32_t codes[MAX_CHAR] : Code préfixe, longueurs au plus tableBits.
+ * - unsigned tableBits : Largeur de la table.
+ * - uint16_t* table : Reçoit les 2^tableBits entrées.
+ */
+static void buildDecodeTable(const unsigned char lengths[MAX_CHAR], const uint32_t codes[MAX_CHAR],
+                             unsigned tableBits, uint16_t* table) {
+    for (uint32_t i = 0; i < (1u << tableBits); i++) {
+        table[i] = (uint16_t)tableBits;
+    }
+    for (int i = 0; i < MAX_CHAR; i++) {
+        if (lengths[i]) {
+            uint32_t first = codes[i] << (tableBits - lengths[i]);
+            uint32_t count = 1u << (tableBits - lengths[i]);
+            for (uint32_t j = 0; j < count; j++) {
+                table[first + j] = (uint16_t)((i << 8) | lengths[i]);
+            }
+        }
+    }
 }
 
+/**
+ * Fonction : decodeStreams
+ * Description : Décode les flux d'un bloc avec le noyau spécialisé pour la longueur maximale des
+ *               codes et le nombre de flux. Le décodage avance par tranches de CRC32C_TRANCHE octets
+ *               dont le CRC32C est calculé aussitôt, tant qu'elles sont dans le cache.
+ *               Chaque flux doit être consommé exactement, bits de bourrage compris.
+ * Paramètres :
+ * - struct BitReader readers[] : Un lecteur par flux, positionné au début du flux.
+ * - unsigned streams : Nombre de flux (1, 2 ou 4).
+ * - const unsigned char lengths[MAX_CHAR], const uint32_t codes[MAX_CHAR] : Code préfixe du bloc.
+ * - int maxLength : Plus grande longueur de code (au plus HUFFMAN_MAX_CODE_LENGTH).
+ * - unsigned char* output, uint32_t size : Destination et nombre d'octets à produire.
+ * - uint32_t* dataCrc : Reçoit le CRC32C des octets produits.
+ * Retour :
+ * - int : 0 en cas de succès, -1 si un flux ne correspond pas au nombre d'octets annoncé.
+ */
+static int decodeStreams(struct BitReader readers[], unsigned streams,
+                         const unsigned char lengths[MAX_CHAR], const uint32_t codes[MAX_CHAR], int maxLength,
+                         unsigned char* output, uint32_t size, uint32_t* dataCrc) {
+    int lengthClass = kernelLengthClass((unsigned)maxLength);
+    DecodeKernel kernel = decodeKernels[lengthClass][kernelStreamClass(streams)];
+    uint16_t table[1u << kernelTableBits[lengthClass]]; // De 4 Ko (codes de 11 bits) à 64 Ko
+    buildDecodeTable(lengths, codes, kernelTableBits[lengthClass], table);
+
+    // Les tranches commencent sur un multiple de streams : l'octet o reste dans le flux o % streams
+    uint32_t crc = CRC32C_INIT;
+    for (uint32_t start = 0; start < size; start += CRC32C_TRANCHE) {
+        uint32_t count = size - start < CRC32C_TRANCHE ? size - start : CRC32C_TRANCHE;
+        kernel(readers, output + start, count, table);
+        crc = crc32c_maj(crc, output + start, count);
+    }
+
+    for (unsigned k = 0; k < streams; k++) {
+        if ((readers[k].pos + 7) / 8 != readers[k].size) {
+            fprintf(stderr, "Bloc malformé : taille du flux %u incohérente\n", k + 1);
+            return -1;
+        }
+    }
+    *dataCrc = crc;
+    return 0;
+}
 
 /**
- * Fonction : decompressFile
- * Description : Décompresse un fichier compressé avec Huffman. Reconstruit l'arbre de Huffman
- *               à partir de la table des fréquences et parcourt les bits pour recréer le contenu original.
+ * Fonction : decompressBlock
+ * Description : Décompresse un bloc HUF3 lu par lire_bloc. Les longueurs de codes sont recalculées
+ *               à partir de la table des fréquences et de la limite du bloc, puis le décodage est
+ *               confié au noyau choisi d'après la description des flux (voir decodeStreams).
+ *               Le bloc n'est pas supposé fiable : la table des fréquences doit totaliser
+ *               taille_originale, la description des flux doit couvrir exactement le reste du corps
+ *               et chaque flux doit être consommé exactement.
  * Paramètres :
- * - const char* inputFile : Nom du fichier compressé en entrée.
- * - const char* outputFile : Nom du fichier décompressé en sortie.
+ * - const struct EnTeteBloc* header : En-tête du bloc (tailles déjà bornées par lire_bloc).
+ * - const unsigned char* body : Corps du bloc (table des fréquences, description des flux, flux).
+ * - unsigned char* output : Tampon d'au moins header->taille_originale octets.
+ * Retour :
+ * - int : 0 en cas de succès, -1 si le bloc est malformé ou si les données ne correspondent pas au CRC.
  */
+int decompressBlock(const struct EnTeteBloc* header, const unsigned char* body, unsigned char* output) {
+    int freq[MAX_CHAR];
+    struct HuffmanStreams streamInfo;
+    if (header->taille_compressee < sizeof(freq) + sizeof(streamInfo)) {
+        fprintf(stderr, "Bloc malformé : table des fréquences incomplète\n");
+        return -1;
+    }
+    memcpy(freq, body, sizeof(freq));
+    memcpy(&streamInfo, body + sizeof(freq), sizeof(streamInfo));
+    const unsigned char* in = body + sizeof(freq) + sizeof(streamInfo);
+    size_t available = header->taille_compressee - sizeof(freq) - sizeof(streamInfo);
+
+    unsigned long long total;
+    int symbols = checkFrequencies(freq, &total);
+    if (symbols <= 0 || total != header->taille_originale) {
+        fprintf(stderr, "Bloc malformé : table des fréquences incohérente\n");
+        return -1;
+    }
 
-void decompressFile(const char* inputFile, const char* outputFile) {
-    printf("Début de la décompression...\n");
+    if ((streamInfo.count != 1 && streamInfo.count != 2 && streamInfo.count != 4) ||
+        streamInfo.maxCodeLength < HUFFMAN_MIN_CODE_LENGTH || streamInfo.maxCodeLength > HUFFMAN_MAX_CODE_LENGTH ||
+        streamInfo.reserved != 0) {
+        fprintf(stderr, "Bloc malformé : description des flux invalide\n");
+        return -1;
+    }
 
-    // Ouverture du fichier compressé en mode binaire
-    FILE* inFile = fopen(inputFile, "rb");
-    if (!inFile) {
-        perror("Échec de l'ouverture du fichier d'entrée");
-        return;
+    // Les flux se suivent et couvrent exactement le reste du corps
+    struct BitReader readers[HUFFMAN_MAX_STREAMS];
+    size_t offset = 0;
+    for (int k = 0; k < HUFFMAN_MAX_STREAMS; k++) {
+        if ((k >= streamInfo.count && streamInfo.sizes[k] != 0) || streamInfo.sizes[k] > available - offset) {
+            fprintf(stderr, "Bloc malformé : description des flux invalide\n");
+            return -1;
+        }
+        readers[k].data = in + offset;
+        readers[k].size = streamInfo.sizes[k];
+        readers[k].pos = 0;
+        offset += streamInfo.sizes[k];
+    }
+    if (offset != available) {
+        fprintf(stderr, "Bloc malformé : taille des données compressées incohérente\n");
+        return -1;
+    }
+
+    uint32_t dataCrc;
+    if (symbols == 1) {
+        // Un seul symbole : aucun bit n'a été écrit
+        if (available != 0) {
+            fprintf(stderr, "Bloc malformé : taille des données compressées incohérente\n");
+            return -1;
+        }
+        int symbol = 0;
+        while (freq[symbol] == 0) {
+            symbol++;
+        }
+        memset(output, symbol, header->taille_originale);
+        dataCrc = crc32c_maj(CRC32C_INIT, output, header->taille_originale);
+    } else {
+        unsigned char lengths[MAX_CHAR];
+        uint32_t codes[MAX_CHAR];
+        int maxLength = computeCodeLengths(freq, streamInfo.maxCodeLength, lengths);
+        canonicalCodes(lengths, codes);
+        if (decodeStreams(readers, streamInfo.count, lengths, codes, maxLength,
+                          output, header->taille_originale, &dataCrc) != 0) {
+            return -1;
+        }
+    }
+
+    if (dataCrc != header->crc_donnees) {
+        fprintf(stderr, "Données corrompues : CRC32C des données incorrect\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Fonction : decompressBlockV2
+ * Description : Décompresse un bloc HUF2 (codes lus dans l'arbre, un seul flux). Quand aucun code
+ *               ne dépasse HUFFMAN_MAX_CODE_LENGTH bits, le décodage passe par le noyau à un flux ;
+ *               sinon l'arbre est parcouru bit par bit. Mêmes contrôles que decompressBlock.
+ * Paramètres :
+ * - const struct EnTeteBloc* header : En-tête du bloc (tailles déjà bornées par lire_bloc).
+ * - const unsigned char* body : Corps du bloc (table des fréquences puis bits compressés).
+ * - unsigned char* output : Tampon d'au moins header->taille_originale octets.
+ * Retour :
+ * - int : 0 en cas de succès, -1 si le bloc est malformé ou si les données ne correspondent pas au CRC.
+ */
+static int decompressBlockV2(const struct EnTeteBloc* header, const unsigned char* body, unsigned char* output) {
+    int freq[MAX_CHAR];
+    if (header->taille_compressee < sizeof(freq)) {
+        fprintf(stderr, "Bloc malformé : table des fréquences incomplète\n");
+        return -1;
+    }
+    memcpy(freq, body, sizeof(freq));
+    const unsigned char* in = body + sizeof(freq);
+    const unsigned char* end = body + header->taille_compressee;
+
+    unsigned long long total;
+    int symbols = checkFrequencies(freq, &total);
+    if (symbols <= 0 || total != header->taille_originale) {
+        fprintf(stderr, "Bloc malformé : table des fréquences incohérente\n");
+        return -1;
+    }
+
+    struct CodeTree tree;
+    buildCodeTree(freq, &tree);
+    struct MinHeapNode* root = tree.root;
+
+    // La taille des bits compressés est entièrement déterminée par la table
+    unsigned long long totalBits = 0;
+    int maxLength = 0;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        totalBits += (unsigned long long)freq[i] * tree.lengths[i];
+        if (tree.lengths[i] > maxLength) {
+            maxLength = tree.lengths[i];
+        }
+    }
+    if ((totalBits + 7) / 8 != (unsigned long long)(end - in)) {
+        fprintf(stderr, "Bloc malformé : taille des données compressées incohérente\n");
+        return -1;
+    }
+
+    // Codes assez courts : décodage par le noyau à un flux, avec les codes de l'arbre
+    if (symbols > 1 && maxLength <= HUFFMAN_MAX_CODE_LENGTH) {
+        struct BitReader reader = { in, (size_t)(end - in), 0 };
+        uint32_t dataCrc;
+        if (decodeStreams(&reader, 1, tree.lengths, tree.codes, maxLength, output, header->taille_originale, &dataCrc) != 0) {
+            return -1;
+        }
+        if (dataCrc != header->crc_donnees) {
+            fprintf(stderr, "Données corrompues : CRC32C des données incorrect\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    uint32_t written = 0, checked = 0;
+    uint32_t dataCrc = CRC32C_INIT;
+
+    if (symbols == 1) {
+        // Un seul symbole : l'arbre se réduit à une feuille et aucun bit n'a été écrit
+        memset(output, (unsigned char)root->data, header->taille_originale);
+        written = header->taille_originale;
+    }
+
+    struct MinHeapNode* current = root;
+
+    // Parcours des bits jusqu'à avoir produit le nombre d'octets annoncé (les bits de bourrage sont ignorés)
+    while (written < header->taille_originale && in < end) {
+        unsigned char byte = *in++;
+        for (int i = 7; i >= 0 && written < header->taille_originale; i--) {
+            current = ((byte >> i) & 1) ? current->right : current->left;
+            if (!current->left && !current->right) {
+                output[written++] = current->data;
+                current = root;
+            }
+        }
+        // CRC de la tranche qui vient d'être produite, encore dans le cache
+        if (written - checked >= CRC32C_TRANCHE) {
+            dataCrc = crc32c_maj(dataCrc, output + checked, written - checked);
+            checked = written;
+        }
     }
+    dataCrc = crc32c_maj(dataCrc, output + checked, written - checked);
 
+    if (written != header->taille_originale) {
+        fprintf(stderr, "Bloc malformé : données compressées épuisées\n");
+        return -1;
+    }
+    if (dataCrc != header->crc_donnees) {
+        fprintf(stderr, "Données corrompues : CRC32C des données incorrect\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Fonction : decompressLegacyStream
+ * Description : Décompresse un flux produit par l'ancien format (table des fréquences suivie
+ *               d'un flux de bits unique, sans nombre magique ni CRC).
+ *               Le nombre de symboles n'y est pas stocké mais vaut la somme des fréquences :
+ *               le décodage s'arrête là, sans interpréter les bits de bourrage.
+ * Paramètres :
+ * - FILE* inFile : Fichier compressé, positionné au début.
+ * - FILE* outFile : Fichier de sortie.
+ * - unsigned long long* totalChars : Reçoit le nombre de caractères décompressés.
+ * - ProgressCallback progress, void* userData : Suivi de l'avancement, voir decompressStream.
+ * Retour :
+ * - int : 0 en cas de succès, -1 en cas d'erreur ou d'annulation.
+ */
+static int decompressLegacyStream(FILE* inFile, FILE* outFile, unsigned long long* totalChars,
+                                  ProgressCallback progress, void* userData) {
     // Lecture de la table de fréquences
     int freq[MAX_CHAR];
     if (fread(freq, sizeof(int), MAX_CHAR, inFile) != MAX_CHAR) {
-        perror("Échec de la lecture de la table de fréquences");
-        fclose(inFile);
-        return;
+        fprintf(stderr, "Échec de la lecture de la table de fréquences\n");
+        return -1;
     }
 
-    // Étape 1 : Lire la table de fréquences à partir du fichier compressé et reconstruire l'arbre de Huffman
-    char codes[MAX_CHAR][MAX_CHAR] = {0};
-    buildHuffmanTree(freq, codes);
-    struct MinHeapNode* root = buildTreeFromCodes(codes, freq);
-
-    // Ouverture du fichier de sortie pour écrire les données décompressées
-    FILE* outFile = fopen(outputFile, "w");
-    if (!outFile) {
-        perror("Échec de l'ouverture du fichier de sortie");
-        fclose(inFile);
-        return;
+    int symbols = checkFrequencies(freq, totalChars);
+    if (symbols < 0) {
+        fprintf(stderr, "Table des fréquences invalide\n");
+        return -1;
+    }
+    if (symbols == 0) {
+        return 0; // Fichier original vide
     }
 
+    // Étape 1 : Lire la table de fréquences à partir du fichier compressé et reconstruire l'arbre de Huffman
+    struct CodeTree tree;
+    buildCodeTree(freq, &tree);
+    struct MinHeapNode* root = tree.root;
+
     // Variables pour le parcours des bits et l'écriture des caractères
     struct MinHeapNode* current = root;
-    unsigned long totalBitsRead = 0; // Compteur de bits lus
-    unsigned long totalCharsWritten = 0; // Compteur de caractères écrits
-    unsigned char byte;
+    unsigned long long totalCharsWritten = 0; // Compteur de caractères écrits
+    int byte;
+
+    if (symbols == 1) {
+        // Un seul symbole : l'ancien encodeur n'écrivait aucun bit, on écrit par paquets
+        unsigned char run[4096];
+        memset(run, (unsigned char)root->data, sizeof(run));
+        while (totalCharsWritten < *totalChars) {
+            size_t count = *totalChars - totalCharsWritten < sizeof(run) ? (size_t)(*totalChars - totalCharsWritten) : sizeof(run);
+            fwrite(run, 1, count, outFile);
+            totalCharsWritten += count;
+        }
+    }
 
     // Étape 2 : Parcourir les bits du fichier compressé, traverser l'arbre de Huffman, et reconstituer les caractères
-    // Lecture des bits et parcours de l'arbre de Huffman
-    while (fread(&byte, sizeof(unsigned char), 1, inFile) == 1) {
-        for (int i = 7; i >= 0; i--) {  // Parcourt chaque bit du byte
+    unsigned long bytesRead = 0;
+    while (totalCharsWritten < *totalChars && (byte = fgetc(inFile)) != EOF) {
+        // Avancement signalé tous les 64 Ko lus
+        if ((++bytesRead & 0xFFFF) == 0 && progress && progress((unsigned long long)ftell(inFile), userData) != 0) {
+            fprintf(stderr, "Décompression annulée\n");
+            return -1;
+        }
+        for (int i = 7; i >= 0 && totalCharsWritten < *totalChars; i--) {  // Parcourt chaque bit du byte
             int bit = (byte >> i) & 1;
             current = bit ? current->right : current->left;
-            totalBitsRead++;
 
             // Si nous atteignons une feuille, écrire le caractère dans le fichier de sortie
             if (!current->left && !current->right) {
@@ -362,57 +1008,715 @@ void decompressFile(const char* inputFile, const char* outputFile) {
         }
     }
 
-    printf("Décompression terminée.\n");
-    printf("Résumé de la décompression :\n");
-    printf(" - Total des bits lus : %lu\n", totalBitsRead);
-    printf(" - Total des caractères décompressés : %lu\n", totalCharsWritten);
+    if (totalCharsWritten != *totalChars) {
+        fprintf(stderr, "Flux tronqué : %llu caractères sur %llu\n", totalCharsWritten, *totalChars);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Fonction : isLegacyFile
+ * Description : Indique si un fichier sans nombre magique est un fichier Huffman de l'ancien format :
+ *               une table des fréquences valide suivie d'exactement les octets que demandent les codes
+ *               de ces caractères. Distingue ces fichiers des anciens fichiers LZW, eux aussi sans
+ *               nombre magique.
+ * Paramètres :
+ * - const char* inputFile : Nom du fichier.
+ * Retour :
+ * - int : 1 si c'est un fichier de l'ancien format, 0 sinon.
+ */
+int isLegacyFile(const char* inputFile) {
+    int freq[MAX_CHAR];
+    unsigned long long total;
+    FILE* file = fopen(inputFile, "rb");
+    if (!file) {
+        return 0;
+    }
+    int complete = fread(freq, sizeof(int), MAX_CHAR, file) == MAX_CHAR;
+    fclose(file);
+    if (!complete || checkFrequencies(freq, &total) < 0) {
+        return 0;
+    }
+
+    struct CodeTree tree;
+    unsigned long long bits = 0;
+    buildCodeTree(freq, &tree);
+    for (int i = 0; i < MAX_CHAR; i++) {
+        bits += (unsigned long long)freq[i] * tree.lengths[i];
+    }
+    long size = getFileSize(inputFile);
+    return size >= 0 && (unsigned long long)size == sizeof(freq) + (bits + 7) / 8;
+}
+
+/* Décodage parallèle de l'ancien format. Le flux de bits est découpé en tranches, chacune décodée
+ * par un thread à partir de son premier bit, sans savoir si un code y commence. Les codes de
+ * Huffman se resynchronisent vite : décodée depuis la vraie frontière (la fin de la tranche
+ * précédente), la tranche retombe au bout de quelques symboles sur le début d'un des codes retenus
+ * pendant le décodage spéculatif, et la suite est alors identique. */
+#define LEGACY_TABLE_BITS 11            // Bits lus d'un coup par la table de décodage
+#define LEGACY_MARGIN 64                // Octets lus après une fenêtre : un code (255 bits au plus) peut en déborder
+#define LEGACY_MAX_THREADS 64           // Tranches au plus par fenêtre
+// Réglages redéfinissables à la compilation (la cible de fuzzing les réduit pour découper de petites entrées)
+#ifndef LEGACY_CHUNK_SYMBOLS
+#define LEGACY_CHUNK_SYMBOLS (1 << 20)  // Symboles au plus par tranche (fixe la taille des tranches), multiple de 8
+#endif
+#ifndef LEGACY_SYNC_MARKS
+#define LEGACY_SYNC_MARKS 1024          // Codes retenus au début de chaque tranche pour la resynchronisation
+#endif
+#ifndef LEGACY_MIN_SIZE
+#define LEGACY_MIN_SIZE (1 << 20)       // Octets de flux au moins par thread, sinon moins de threads
+#endif
+
+// Arbre de l'ancien format et table de décodage de ses codes courts
+struct LegacyDecoder {
+    struct CodeTree tree;
+    uint32_t table[1 << LEGACY_TABLE_BITS]; // (octet << 8) | longueur, ou (nœud << 8) pour un code plus long
+    int minLength;                          // Longueur du code le plus court
+};
+
+// Partie du flux en mémoire. Les positions, en bits, sont comptées depuis le début du flux de bits
+struct LegacyWindow {
+    const unsigned char* data; // Octets lus, suivis de 8 octets nuls
+    uint64_t base;             // Position de data[0] (multiple de 8)
+    uint64_t readLimit;        // Fin des bits lus
+};
+
+// Tranche décodée par un thread
+struct LegacyChunk {
+    const struct LegacyDecoder* decoder;
+    const struct LegacyWindow* window;
+    uint64_t start;                        // Début supposé, puis exact après la resynchronisation
+    uint64_t limit;                        // Les codes commençant avant limit appartiennent à la tranche
+    uint64_t end;                          // Fin du dernier code décodé (avant limit : code incomplet)
+    unsigned char* out;                    // Symboles décodés depuis start
+    size_t count;
+    uint64_t marks[LEGACY_SYNC_MARKS];     // Début des premiers symboles de out
+    unsigned char prefix[LEGACY_SYNC_MARKS]; // Symboles décodés depuis la vraie frontière avant la resynchronisation
+    size_t prefixCount;
+    size_t skip;                           // Symboles de out remplacés par prefix
+    pthread_t worker;
+    int started;                           // worker a été créé pour cette fenêtre
+};
+
+// Table de décodage : chaque motif de LEGACY_TABLE_BITS bits est suivi dans l'arbre depuis la racine
+static void buildLegacyDecoder(const int freq[MAX_CHAR], struct LegacyDecoder* decoder) {
+    buildCodeTree(freq, &decoder->tree);
+    decoder->minLength = 255;
+    for (int i = 0; i < MAX_CHAR; i++) {
+        if (freq[i] && decoder->tree.lengths[i] < decoder->minLength) {
+            decoder->minLength = decoder->tree.lengths[i];
+        }
+    }
+    for (uint32_t pattern = 0; pattern < (1u << LEGACY_TABLE_BITS); pattern++) {
+        const struct MinHeapNode* node = decoder->tree.root;
+        int length = 0;
+        while (node->left && length < LEGACY_TABLE_BITS) {
+            node = (pattern >> (LEGACY_TABLE_BITS - 1 - length)) & 1 ? node->right : node->left;
+            length++;
+        }
+        decoder->table[pattern] = node->left ? (uint32_t)(node - decoder->tree.nodes) << 8
+                                             : (uint32_t)(unsigned char)node->data << 8 | (uint32_t)length;
+    }
+}
+
+// Décode le symbole commençant à *pos et avance *pos ; retourne -1 si le code dépasse les bits lus
+static inline int decodeLegacySymbol(const struct LegacyDecoder* decoder, const struct LegacyWindow* window,
+                                     uint64_t* pos) {
+    uint64_t offset = *pos - window->base;
+    uint64_t bits = load64be(window->data + (offset >> 3)) << (offset & 7);
+    uint32_t entry = decoder->table[bits >> (64 - LEGACY_TABLE_BITS)];
+    uint32_t length = entry & 0xFF;
+    if (length) {
+        if (*pos + length > window->readLimit) {
+            return -1;
+        }
+        *pos += length;
+        return (int)(entry >> 8);
+    }
 
-    // Fermeture des fichiers
-    fclose(inFile);
-    fclose(outFile);
+    // Code plus long que la table : la suite est lue bit à bit dans l'arbre
+    uint64_t p = *pos + LEGACY_TABLE_BITS;
+    if (p > window->readLimit) {
+        return -1;
+    }
+    const struct MinHeapNode* node = &decoder->tree.nodes[entry >> 8];
+    while (node->left) {
+        if (p >= window->readLimit) {
+            return -1;
+        }
+        offset = p++ - window->base;
+        node = (window->data[offset >> 3] >> (7 - (offset & 7))) & 1 ? node->right : node->left;
+    }
+    *pos = p;
+    return (unsigned char)node->data;
 }
 
+// Décode la tranche depuis start, en retenant le début des premiers symboles
+static void decodeLegacyChunk(struct LegacyChunk* chunk) {
+    const struct LegacyDecoder* decoder = chunk->decoder;
+    const struct LegacyWindow* window = chunk->window;
+    uint64_t pos = chunk->start;
+    size_t count = 0;
+    while (pos < chunk->limit) {
+        uint64_t at = pos;
+        int symbol = decodeLegacySymbol(decoder, window, &pos);
+        if (symbol < 0) {
+            break;
+        }
+        if (count < LEGACY_SYNC_MARKS) {
+            chunk->marks[count] = at;
+        }
+        chunk->out[count++] = (unsigned char)symbol;
+    }
+    chunk->count = count;
+    chunk->end = pos;
+}
+
+static void* decodeLegacyChunkTask(void* arg) {
+    decodeLegacyChunk(arg);
+    return NULL;
+}
 
 /**
- * Fonction : buildTreeFromCodes
- * Description : Reconstruit l'arbre de Huffman à partir des codes de Huffman et des fréquences des caractères.
+ * Fonction : resyncLegacyChunk
+ * Description : Raccorde une tranche décodée de manière spéculative à la fin de la précédente.
+ *               Les symboles sont redécodés depuis la vraie frontière jusqu'à tomber sur le début
+ *               d'un symbole déjà décodé : la suite de out est alors la bonne. Si cela n'arrive pas
+ *               parmi les positions retenues, la tranche est entièrement redécodée.
  * Paramètres :
- * - char codes[MAX_CHAR][MAX_CHAR] : Tableau des codes Huffman pour chaque caractère.
- * - int freq[MAX_CHAR] : Tableau des fréquences des caractères.
+ * - struct LegacyChunk* chunk : Tranche décodée depuis son début supposé.
+ * - uint64_t boundary : Fin du dernier code de la tranche précédente (au moins chunk->start).
+ */
+static void resyncLegacyChunk(struct LegacyChunk* chunk, uint64_t boundary) {
+    chunk->prefixCount = 0;
+    chunk->skip = 0;
+    if (boundary == chunk->start) {
+        return;
+    }
+    size_t marks = chunk->count < LEGACY_SYNC_MARKS ? chunk->count : LEGACY_SYNC_MARKS;
+    size_t m = 0;
+    uint64_t pos = boundary;
+    while (chunk->prefixCount < LEGACY_SYNC_MARKS) {
+        while (m < marks && chunk->marks[m] < pos) {
+            m++;
+        }
+        if (m < marks && chunk->marks[m] == pos) {
+            chunk->skip = m; // Resynchronisé : out[m] et la suite commencent au même bit
+            chunk->start = boundary;
+            return;
+        }
+        if (m == marks && marks < chunk->count) {
+            break; // Au-delà des positions retenues
+        }
+        int symbol = pos < chunk->limit ? decodeLegacySymbol(chunk->decoder, chunk->window, &pos) : -1;
+        if (symbol < 0) {
+            // Fin de la tranche (ou code incomplet) sans resynchronisation : prefix la contient entière
+            chunk->skip = chunk->count;
+            chunk->start = boundary;
+            chunk->end = pos;
+            return;
+        }
+        chunk->prefix[chunk->prefixCount++] = (unsigned char)symbol;
+    }
+    chunk->start = boundary;
+    chunk->prefixCount = 0;
+    decodeLegacyChunk(chunk);
+}
+
+// Écrit size octets, en reprenant après les écritures partielles
+static int writeAll(int fd, const unsigned char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            perror("Échec de l'écriture du fichier de sortie");
+            return -1;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+// Écrit au plus *remaining des size symboles et les décompte de *remaining
+static int writeSymbols(int fd, const unsigned char* symbols, size_t size, unsigned long long* remaining) {
+    if (size > *remaining) {
+        size = (size_t)*remaining; // Au-delà : bits de bourrage du dernier octet
+    }
+    *remaining -= size;
+    return writeAll(fd, symbols, size);
+}
+
+// Lit size octets à la position offset (moins seulement si le fichier est plus court)
+static ssize_t readAt(int fd, unsigned char* data, size_t size, off_t offset) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = pread(fd, data + done, size - done, offset + (off_t)done);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            return -1;
+        }
+        if (got == 0) {
+            break;
+        }
+        done += (size_t)got;
+    }
+    return (ssize_t)done;
+}
+
+/**
+ * Fonction : decompressLegacyFile
+ * Description : Décode un fichier de l'ancien format avec plusieurs threads. Le flux est lu par
+ *               fenêtres de threads tranches ; chaque tranche est décodée en parallèle depuis son
+ *               premier bit, puis raccordée à la précédente (voir resyncLegacyChunk). Le résultat
+ *               est identique à celui de decompressLegacyStream.
+ * Paramètres :
+ * - int inFd : Fichier compressé.
+ * - int outFd : Fichier de sortie, écrit séquentiellement.
+ * - int* threads : Nombre de threads demandés ; reçoit le nombre utilisé, borné par la taille du
+ *   flux (LEGACY_MIN_SIZE octets au moins par thread) et par LEGACY_MAX_THREADS.
+ * - unsigned long long* totalChars : Reçoit le nombre de caractères décompressés.
  * Retour :
- * - struct MinHeapNode* : Racine de l'arbre de Huffman reconstruit.
+ * - int : 0 en cas de succès, -1 en cas d'erreur, 1 si le fichier est trop petit pour être
+ *   découpé ou si la mémoire manque (rien n'a été écrit : il reste à le décoder séquentiellement).
  */
-struct MinHeapNode* buildTreeFromCodes(char codes[MAX_CHAR][MAX_CHAR], int freq[MAX_CHAR]) {
-    struct MinHeapNode* root = newNode('$', 0);  // Créer la racine de l'arbre
+static int decompressLegacyFile(int inFd, int outFd, int* threads, unsigned long long* totalChars) {
+    int freq[MAX_CHAR];
+    struct stat st;
+    if (readAt(inFd, (unsigned char*)freq, sizeof(freq), 0) != (ssize_t)sizeof(freq) || fstat(inFd, &st) != 0) {
+        fprintf(stderr, "Échec de la lecture de la table de fréquences\n");
+        return -1;
+    }
+    int symbols = checkFrequencies(freq, totalChars);
+    if (symbols < 0) {
+        fprintf(stderr, "Table des fréquences invalide\n");
+        return -1;
+    }
+    uint64_t dataBytes = (uint64_t)st.st_size - sizeof(freq);
+    uint64_t useful = dataBytes / LEGACY_MIN_SIZE;
+    if (useful > LEGACY_MAX_THREADS) {
+        useful = LEGACY_MAX_THREADS;
+    }
+    if ((uint64_t)*threads > useful) {
+        *threads = (int)useful;
+    }
+    if (symbols <= 1 || *threads < 2) {
+        return 1;
+    }
+    int count = *threads;
+
+    struct LegacyDecoder* decoder = memoire_allouer(sizeof(*decoder));
+    // Une tranche contient au plus LEGACY_CHUNK_SYMBOLS codes, même tous de la longueur minimale
+    size_t chunkBytes = 0;
+    unsigned char* buffer = NULL;
+    struct LegacyChunk* chunks = memoire_allouer_zero((size_t)count, sizeof(*chunks));
+    int result = decoder && chunks ? 0 : 1;
+    if (result == 0) {
+        buildLegacyDecoder(freq, decoder);
+        chunkBytes = (size_t)LEGACY_CHUNK_SYMBOLS / 8 * (size_t)decoder->minLength;
+        buffer = memoire_allouer((size_t)count * chunkBytes + LEGACY_MARGIN + 8);
+        result = buffer ? 0 : 1;
+    }
+    for (int j = 0; j < count && result == 0; j++) {
+        chunks[j].decoder = decoder;
+        chunks[j].out = memoire_allouer(LEGACY_CHUNK_SYMBOLS + 1);
+        result = chunks[j].out ? 0 : 1; // Mémoire insuffisante : décodage séquentiel
+    }
 
-    printf("Construction de l'arbre à partir des codes de Huffman...\n");
+    struct LegacyWindow window;
+    unsigned long long remaining = *totalChars;
+    uint64_t pos = 0, dataBits = dataBytes * 8;
+    int truncated = 0;
+
+    while (result == 0 && remaining > 0) {
+        uint64_t first = pos >> 3;
+        if (pos >= dataBits) {
+            truncated = 1;
+            result = -1;
+            break;
+        }
+        uint64_t left = dataBytes - first;
+        int used = (int)((left + chunkBytes - 1) / chunkBytes < (uint64_t)count ? (left + chunkBytes - 1) / chunkBytes
+                                                                               : (uint64_t)count);
+        size_t toRead = (size_t)(left < (uint64_t)used * chunkBytes + LEGACY_MARGIN ? left
+                                                                                    : (uint64_t)used * chunkBytes + LEGACY_MARGIN);
+        if (readAt(inFd, buffer, toRead, (off_t)(sizeof(freq) + first)) != (ssize_t)toRead) {
+            perror("Échec de la lecture du fichier d'entrée");
+            result = -1;
+            break;
+        }
+        memset(buffer + toRead, 0, 8);
+        window = (struct LegacyWindow){ buffer, first * 8, (first + toRead) * 8 };
+
+        // Décodage spéculatif : la première tranche commence au bon bit, les autres à leur premier octet
+        for (int j = 0; j < used; j++) {
+            uint64_t limit = (first + (uint64_t)(j + 1) * chunkBytes) * 8;
+            chunks[j].window = &window;
+            chunks[j].start = j == 0 ? pos : (first + (uint64_t)j * chunkBytes) * 8;
+            chunks[j].limit = limit < dataBits ? limit : dataBits;
+            chunks[j].started = j > 0 && pthread_create(&chunks[j].worker, NULL, decodeLegacyChunkTask, &chunks[j]) == 0;
+        }
+        decodeLegacyChunk(&chunks[0]);
+        for (int j = 1; j < used; j++) {
+            if (chunks[j].started) {
+                pthread_join(chunks[j].worker, NULL);
+            } else {
+                decodeLegacyChunk(&chunks[j]); // Thread non créé : décodé ici
+            }
+        }
 
-    // Parcours de tous les caractères pour ajouter des nœuds à l'arbre
-    for (int i = 0; i < MAX_CHAR; i++) {
-        if (freq[i] > 0) { // Si le caractère a une fréquence non nulle
-            struct MinHeapNode* current = root;
-            char* code = codes[i]; // Code Huffman associé au caractère
-            printf("Caractère : '%c' Code : %s\n", (char)i, code);
-
-            // Parcours du code Huffman
-            for (int j = 0; code[j] != '\0'; j++) {
-                if (code[j] == '0') {
-                    if (!current->left) current->left = newNode('$', 0); // Crée un nœud gauche si nécessaire
-                    current = current->left; // Descend à gauche
-                } else {
-                    if (!current->right) current->right = newNode('$', 0); // Crée un nœud droit si nécessaire
-                    current = current->right; // Descend à droite
-                }
+        // Raccordement et écriture, dans l'ordre des tranches
+        uint64_t next = pos;
+        for (int j = 0; j < used && result == 0 && remaining > 0; j++) {
+            struct LegacyChunk* chunk = &chunks[j];
+            if (j > 0) {
+                resyncLegacyChunk(chunk, next);
+            }
+            if (writeSymbols(outFd, chunk->prefix, chunk->prefixCount, &remaining) != 0 ||
+                writeSymbols(outFd, chunk->out + chunk->skip, chunk->count - chunk->skip, &remaining) != 0) {
+                result = -1;
             }
-            current->data = (char)i; // Associe le caractère au nœud feuille
-            printf("Noeud ajouté pour '%c' avec code %s\n", current->data, code);
+            next = chunk->end;
+            if (chunk->end < chunk->limit) {
+                break; // Code incomplet : fin des données
+            }
+        }
+        if (result == 0 && next == pos && remaining > 0) {
+            truncated = 1; // Aucun code complet de plus
+            result = -1;
         }
+        pos = next;
     }
 
-    printf("Arbre de Huffman construit avec succès.\n");
-    return root; // Retourne la racine de l'arbre
+    if (truncated) {
+        fprintf(stderr, "Flux tronqué : %llu caractères sur %llu\n", *totalChars - remaining, *totalChars);
+    }
+    for (int j = 0; chunks && j < count; j++) {
+        memoire_liberer(chunks[j].out);
+    }
+    memoire_liberer(chunks);
+    memoire_liberer(buffer);
+    memoire_liberer(decoder);
+    *totalChars -= remaining;
+    return result;
 }
 
+/**
+ * Fonction : decompressStream
+ * Description : Décompresse un flux Huffman déjà ouvert vers un autre flux. Chaque bloc est vérifié
+ *               (CRC du bloc avant décodage, CRC des données après) avant d'être écrit.
+ *               Les blocs HUF2 et les flux de l'ancien format, sans nombre magique, restent lisibles.
+ * Paramètres :
+ * - FILE* inFile : Flux compressé, positionné au début du flux (pas forcément du fichier).
+ * - FILE* outFile : Flux de sortie.
+ * - unsigned long long* totalChars : Reçoit le nombre de caractères décompressés (peut être NULL).
+ * - ProgressCallback progress : Appelée après chaque bloc avec la position dans le flux compressé (peut être NULL).
+ * - void* userData : Transmis tel quel à progress.
+ * Retour :
+ * - int : 0 en cas de succès, -1 si le flux est malformé, corrompu, tronqué ou si l'opération est annulée.
+ */
+int decompressStream(FILE* inFile, FILE* outFile, unsigned long long* totalChars,
+                     ProgressCallback progress, void* userData) {
+    unsigned long long totalCharsWritten = 0;
+    char magic[TAILLE_MAGIQUE];
+    size_t magicRead = fread(magic, 1, TAILLE_MAGIQUE, inFile);
+    int version2 = magicRead == TAILLE_MAGIQUE && memcmp(magic, HUFFMAN_MAGIC_V2, TAILLE_MAGIQUE) == 0;
+    if (!version2 && (magicRead != TAILLE_MAGIQUE || memcmp(magic, HUFFMAN_MAGIC, TAILLE_MAGIQUE) != 0)) {
+        // Ancien format : les octets lus font partie de la table des fréquences
+        fseek(inFile, -(long)magicRead, SEEK_CUR);
+        int result = decompressLegacyStream(inFile, outFile, &totalCharsWritten, progress, userData);
+        if (totalChars) {
+            *totalChars = totalCharsWritten;
+        }
+        return result;
+    }
+
+    struct EnTeteBloc header;
+    unsigned char* body = NULL;
+    size_t capacity = 0;
+    unsigned char* output = memoire_allouer(HUFFMAN_BLOCK_SIZE);
+    unsigned long totalBlocks = 0;
+    int result;
+
+    while ((result = lire_bloc(inFile, &header, &body, &capacity,
+                               HUFFMAN_BLOCK_SIZE, HUFFMAN_MAX_COMPRESSED)) == 1) {
+        int decoded = !output ? -1 : version2 ? decompressBlockV2(&header, body, output)
+                                              : decompressBlock(&header, body, output);
+        if (decoded != 0) {
+            result = -1;
+            break;
+        }
+        fwrite(output, 1, header.taille_originale, outFile);
+        totalBlocks++;
+        totalCharsWritten += header.taille_originale;
+        if (progress && progress((unsigned long long)ftell(inFile), userData) != 0) {
+            fprintf(stderr, "Décompression annulée\n");
+            result = -2;
+            break;
+        }
+    }
+
+    memoire_liberer(output);
+    memoire_liberer(body);
+
+    if (result == -2) {
+        return -1;
+    }
+    if (result < 0) {
+        fprintf(stderr, "Échec de la décompression au bloc %lu\n", totalBlocks + 1);
+        return -1;
+    }
+    if (totalChars) {
+        *totalChars = totalCharsWritten;
+    }
+    return 0;
+}
+
+// Plus grand corps d'un bloc HUF3 d'au plus blockSize octets et de codes d'au plus maxCodeLength bits :
+// chaque flux est consommé exactement, avec moins d'un octet de bourrage
+static uint32_t maxBodyV3(uint32_t blockSize, int maxCodeLength) {
+    return (uint32_t)(MAX_CHAR * sizeof(int) + sizeof(struct HuffmanStreams) +
+                      ((size_t)blockSize * maxCodeLength + 7) / 8 + HUFFMAN_MAX_STREAMS);
+}
+
+// HUF2 : codes de l'arbre, non limités (moins de 32 bits pour un bloc d'au plus HUFFMAN_BLOCK_SIZE)
+static uint32_t maxBodyV2(uint32_t blockSize, int maxCodeLength) {
+    (void)maxCodeLength;
+    return (uint32_t)(MAX_CHAR * sizeof(int) + 4 * (size_t)blockSize);
+}
+
+// Décodeur de bloc transmis aux travailleurs du pipeline, selon le nombre magique, avec la borne
+// sur le corps de ses blocs
+struct BlockDecoder {
+    int (*decode)(const struct EnTeteBloc* header, const unsigned char* body, unsigned char* output);
+    uint32_t (*maxBody)(uint32_t blockSize, int maxCodeLength);
+};
+static const struct BlockDecoder decoderV3 = { decompressBlock, maxBodyV3 };
+static const struct BlockDecoder decoderV2 = { decompressBlockV2, maxBodyV2 };
+
+// Paramètres du pipeline de décompression (sans le traitement)
+static void decompressParams(const struct HuffmanOptions* options, const struct BlockDecoder* decoder,
+                             struct ParametresPipeline* params) {
+    *params = (struct ParametresPipeline){0};
+    params->decoupage = DECOUPAGE_BLOCS;
+    params->taille_originale_max = options->blockSize;
+    params->taille_compressee_max = decoder->maxBody(options->blockSize, options->maxCodeLength);
+    params->nb_travailleurs = options->threads;
+    params->profondeur = options->depth;
+}
+
+/**
+ * Fonction : huffmanDecompressMemoryBound
+ * Description : Borne la mémoire de travail de decompressFileWith avec ces options, quel que soit le
+ *               fichier : les blocs plus grands que ne le permettent blockSize et maxCodeLength sont
+ *               refusés. La borne couvre aussi les blocs HUF2, dont les codes ne sont pas limités.
+ * Paramètres :
+ * - const struct HuffmanOptions* options : Options de décompression (streams n'est pas utilisé).
+ * Retour :
+ * - size_t : La borne, en octets.
+ */
+size_t huffmanDecompressMemoryBound(const struct HuffmanOptions* options) {
+    struct ParametresPipeline paramsV3, paramsV2;
+    decompressParams(options, &decoderV3, &paramsV3);
+    decompressParams(options, &decoderV2, &paramsV2);
+    size_t boundV3 = borne_memoire_pipeline(&paramsV3, options->blockSize, 0);
+    size_t boundV2 = borne_memoire_pipeline(&paramsV2, options->blockSize, 0);
+    return boundV3 > boundV2 ? boundV3 : boundV2;
+}
+
+// Traitement d'un bloc (en-tête et corps) par un travailleur du pipeline
+static unsigned char* decompressTask(const unsigned char* block, size_t size, size_t* outSize, void* context) {
+    const struct BlockDecoder* decoder = context;
+    struct EnTeteBloc header;
+    memcpy(&header, block, sizeof(header));
+    const unsigned char* body = block + sizeof(header);
+    (void)size;
+
+    if (calculer_crc_bloc(&header, body) != header.crc_bloc) {
+        fprintf(stderr, "Bloc corrompu : CRC32C incorrect\n");
+        return NULL;
+    }
+    unsigned char* output = memoire_allouer(header.taille_originale);
+    if (!output) {
+        fprintf(stderr, "Mémoire insuffisante pour un bloc de %u octets\n", header.taille_originale);
+        return NULL;
+    }
+    if (decoder->decode(&header, body, output) != 0) {
+        memoire_liberer(output);
+        return NULL;
+    }
+    *outSize = header.taille_originale;
+    return output;
+}
+
+/**
+ * Fonction : decompressFileWith
+ * Description : Décompresse un fichier compressé avec Huffman. Les fichiers par blocs (HUF3, HUF2)
+ *               passent par le pipeline (voir executer_pipeline) ; l'ancien format, fait d'un seul
+ *               flux de bits, est découpé en tranches décodées en parallèle (voir decompressLegacyFile),
+ *               ou décodé séquentiellement, sans allocation, avec un seul thread ou s'il est petit.
+ * Paramètres :
+ * - const char* inputFile : Nom du fichier compressé en entrée.
+ * - const char* outputFile : Nom du fichier décompressé en sortie.
+ * - const struct HuffmanOptions* options : Nombre de travailleurs (0 pour un par cœur) et profondeur
+ *   du pipeline ; les blocs de plus de blockSize octets ou dont le corps dépasse ce que permettent
+ *   des codes de maxCodeLength bits sont refusés (voir huffmanDecompressMemoryBound).
+ * - struct StatistiquesPipeline* stats : Reçoit les mesures (peut être NULL) ; pour l'ancien format,
+ *   seuls les octets lus et écrits, la durée, le nombre de threads et la mémoire sont renseignés.
+ * Retour :
+ * - int : 0 en cas de succès, -1 en cas d'erreur (entrée qui est un tube comprise), de corruption ou
+ *   de bloc hors des limites.
+ */
+int decompressFileWith(const char* inputFile, const char* outputFile, const struct HuffmanOptions* options,
+                       struct StatistiquesPipeline* stats) {
+    if (checkOptions(options) != 0) {
+        return -1;
+    }
+
+    // Ouverture du fichier compressé, lu par positions (le nombre magique avant les blocs)
+    int inFd = open(inputFile, O_RDONLY);
+    if (inFd < 0) {
+        perror("Échec de l'ouverture du fichier d'entrée");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(inFd, &st) == 0 && (S_ISFIFO(st.st_mode) || S_ISSOCK(st.st_mode))) {
+        fprintf(stderr, "%s : un tube ne peut pas être décompressé\n", inputFile);
+        close(inFd);
+        return -1;
+    }
+
+    // Ouverture du fichier de sortie pour écrire les données décompressées
+    int outFd = open(outputFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outFd < 0) {
+        perror("Échec de l'ouverture du fichier de sortie");
+        close(inFd);
+        return -1;
+    }
+
+    char magic[TAILLE_MAGIQUE];
+    const struct BlockDecoder* decoder = NULL;
+    if (pread(inFd, magic, TAILLE_MAGIQUE, 0) == TAILLE_MAGIQUE) {
+        if (memcmp(magic, HUFFMAN_MAGIC, TAILLE_MAGIQUE) == 0) {
+            decoder = &decoderV3;
+        } else if (memcmp(magic, HUFFMAN_MAGIC_V2, TAILLE_MAGIQUE) == 0) {
+            decoder = &decoderV2;
+        }
+    }
+
+    struct StatistiquesPipeline measures;
+    int result;
+    if (decoder) {
+        struct ParametresPipeline params;
+        decompressParams(options, decoder, &params);
+        params.traitement = decompressTask;
+        params.contexte = (void*)decoder;
+        result = executer_pipeline(inFd, TAILLE_MAGIQUE, outFd, 0, &params, &measures);
+        close(inFd);
+        close(outFd);
+        if (result != 0) {
+            fprintf(stderr, "Échec de la décompression de %s\n", inputFile);
+        }
+    } else {
+        // Ancien format : un seul flux de bits, découpé en tranches si plusieurs threads sont demandés
+        struct timespec start, end;
+        unsigned long long totalChars = 0;
+        int threads = options->threads > 0 ? options->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        struct CompteurMemoire counter;
+        compteur_memoire_initialiser(&counter);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        result = 1;
+        if (threads > 1) {
+            struct CompteurMemoire* previous = compteur_memoire_attacher(&counter);
+            result = decompressLegacyFile(inFd, outFd, &threads, &totalChars);
+            compteur_memoire_attacher(previous);
+        }
+        if (result == 1) {
+            threads = 1;
+            FILE* inFile = fdopen(inFd, "rb");
+            FILE* outFile = fdopen(outFd, "wb");
+            result = inFile && outFile ? decompressStream(inFile, outFile, &totalChars, NULL, NULL) : -1;
+            if (inFile) fclose(inFile); else close(inFd);
+            if (outFile) fclose(outFile); else close(outFd);
+        } else {
+            close(inFd);
+            close(outFd);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        memset(&measures, 0, sizeof(measures));
+        measures.octets_lus = (unsigned long long)getFileSize(inputFile);
+        measures.octets_ecrits = totalChars;
+        measures.nb_travailleurs = threads;
+        measures.memoire_pic = atomic_load(&counter.pic);
+        measures.duree = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        measures.methode_es = "bloquante";
+    }
+
+    if (result == 0 && stats) {
+        *stats = measures;
+    }
+    return result;
+}
+
+/**
+ * Fonction : decompressFile
+ * Description : Décompresse un fichier compressé avec Huffman (voir decompressFileWith) et affiche le résumé.
+ * Paramètres :
+ * - const char* inputFile : Nom du fichier compressé en entrée.
+ * - const char* outputFile : Nom du fichier décompressé en sortie.
+ * Retour :
+ * - int : 0 en cas de succès, -1 en cas d'erreur ou de corruption.
+ */
+int decompressFile(const char* inputFile, const char* outputFile) {
+    printf("Début de la décompression...\n");
+
+    struct HuffmanOptions options;
+    struct StatistiquesPipeline stats;
+    huffmanLevelOptions(HUFFMAN_LEVEL, &options);
+    options.blockSize = HUFFMAN_BLOCK_SIZE; // Tous les fichiers sont acceptés
+    options.maxCodeLength = HUFFMAN_MAX_CODE_LENGTH;
+    int result = decompressFileWith(inputFile, outputFile, &options, &stats);
+    if (result == 0) {
+        printf("Décompression terminée.\n");
+        printf("Résumé de la décompression :\n");
+        printf(" - Total des caractères décompressés : %llu\n", stats.octets_ecrits);
+        if (stats.nb_blocs > 0) {
+            afficher_statistiques_pipeline(&stats); // Fichier par blocs
+        }
+    }
+    return result;
+}
+
+/**
+ * Fonction : verifyFile
+ * Description : Vérifie l'intégrité d'un fichier HUF3 ou HUF2 sans le décompresser ni écrire de sortie.
+ * Paramètres :
+ * - const char* inputFile : Nom du fichier compressé.
+ * Retour :
+ * - int : 0 si tous les blocs sont intacts, -1 sinon.
+ */
+int verifyFile(const char* inputFile) {
+    // Les deux formats partagent la même structure de blocs, seul le nombre magique change
+    const char* magic = HUFFMAN_MAGIC;
+    char magicRead[TAILLE_MAGIQUE];
+    FILE* file = fopen(inputFile, "rb");
+    if (file) {
+        if (fread(magicRead, 1, TAILLE_MAGIQUE, file) == TAILLE_MAGIQUE &&
+            memcmp(magicRead, HUFFMAN_MAGIC_V2, TAILLE_MAGIQUE) == 0) {
+            magic = HUFFMAN_MAGIC_V2;
+        }
+        fclose(file);
+    }
+    return verifier_fichier_blocs(inputFile, magic, HUFFMAN_BLOCK_SIZE, HUFFMAN_MAX_COMPRESSED);
+}
+
+
 // aux pour benchmark
 /**
  * getFileSize
@@ -1,8 +1,52 @@
 #ifndef HUFFMAN_H
 #define HUFFMAN_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "../commun/bloc.h"
+#include "../commun/pipeline.h"
+
 #define MAX_CHAR 256
 
+#define HUFFMAN_MAGIC "HUF3" // Nombre magique du format par blocs (codes canoniques, flux entrelacés)
+#define HUFFMAN_MAGIC_V2 "HUF2" // Format par blocs précédent (codes de l'arbre, un seul flux), toujours lisible
+#define HUFFMAN_BLOCK_SIZE (1 << 20) // Taille maximale d'un bloc avant compression (1 Mo)
+// Borne sur le corps d'un bloc : table des fréquences plus 32 bits par symbole
+// (aucun code ne dépasse 30 bits pour un bloc de 1 Mo)
+#define HUFFMAN_MAX_COMPRESSED (MAX_CHAR * sizeof(int) + 4 * HUFFMAN_BLOCK_SIZE)
+
+#define HUFFMAN_MAX_STREAMS 4 // Flux entrelacés par bloc : 1, 2 ou 4
+#define HUFFMAN_STREAMS 4 // Nombre de flux utilisé par compressBlock
+#define HUFFMAN_MIN_CODE_LENGTH 8 // Plus petite limite acceptée : 256 codes doivent tenir
+#define HUFFMAN_MAX_CODE_LENGTH 15 // Plus grande limite acceptée (table de décodage de 2^15 entrées)
+#define HUFFMAN_CODE_LENGTH 12 // Limite utilisée par compressBlock (table de 8 Ko, tient dans le cache L1)
+#define HUFFMAN_LEVEL 6 // Niveau par défaut (voir huffmanLevelOptions), celui de compressBlock
+#define HUFFMAN_LOW_MEMORY_BLOCK_SIZE (32 * 1024) // Taille des blocs du mode économe (voir huffmanLowMemoryOptions)
+
+// Réglages de compression d'un fichier (voir huffmanLevelOptions) ; en décompression, blockSize et
+// maxCodeLength sont les limites admises
+struct HuffmanOptions {
+    uint32_t blockSize;     // Octets par bloc avant compression, au plus HUFFMAN_BLOCK_SIZE
+    int streams;            // Flux entrelacés : 1, 2 ou 4
+    int maxCodeLength;      // De HUFFMAN_MIN_CODE_LENGTH à HUFFMAN_MAX_CODE_LENGTH
+    int threads;            // Travailleurs du pipeline, 0 : un par cœur
+    int depth;              // Blocs en mémoire au plus, 0 : valeur par défaut du pipeline
+};
+
+// Description des flux d'un bloc HUF3, placée après la table des fréquences.
+// Les flux suivent, dans l'ordre, chacun de sizes[i] octets (0 au-delà de count).
+struct HuffmanStreams {
+    uint8_t count;          // Nombre de flux : 1, 2 ou 4
+    uint8_t maxCodeLength;  // Limite appliquée aux longueurs de codes, de 8 à 15
+    uint16_t reserved;      // 0
+    uint32_t sizes[HUFFMAN_MAX_STREAMS];
+};
+
+// Suivi d'une opération longue : appelée régulièrement avec le nombre d'octets d'entrée traités.
+// Une valeur de retour non nulle demande l'annulation de l'opération.
+typedef int (*ProgressCallback)(unsigned long long processed, void* userData);
+
 struct MinHeapNode {
     char data;
     unsigned freq;
@@ -10,10 +54,26 @@ struct MinHeapNode {
 };
 
 // Fonction declarations
-struct MinHeapNode* newNode(char data, unsigned freq);
+unsigned char* compressBlock(const unsigned char* input, uint32_t size, size_t* blockSize);
+unsigned char* compressBlockWith(const unsigned char* input, uint32_t size, int streams, int maxCodeLength,
+                                size_t* blockSize);
+int decompressBlock(const struct EnTeteBloc* header, const unsigned char* body, unsigned char* output);
+int compressStream(FILE* inFile, FILE* outFile, unsigned long long* originalSize,
+                   ProgressCallback progress, void* userData);
+void huffmanLevelOptions(int level, struct HuffmanOptions* options);
+void huffmanLowMemoryOptions(struct HuffmanOptions* options);
+size_t huffmanCompressMemoryBound(const struct HuffmanOptions* options);
+size_t huffmanDecompressMemoryBound(const struct HuffmanOptions* options);
+int compressFileWith(const char* inputFile, const char* outputFile, const struct HuffmanOptions* options,
+                     struct StatistiquesPipeline* stats);
 void compressFile(const char* inputFile, const char* outputFile);
-void decompressFile(const char* inputFile, const char* outputFile);
-struct MinHeapNode* buildTreeFromCodes(char codes[MAX_CHAR][MAX_CHAR], int freq[MAX_CHAR]);
+int decompressStream(FILE* inFile, FILE* outFile, unsigned long long* totalChars,
+                     ProgressCallback progress, void* userData);
+int decompressFileWith(const char* inputFile, const char* outputFile, const struct HuffmanOptions* options,
+                       struct StatistiquesPipeline* stats);
+int decompressFile(const char* inputFile, const char* outputFile);
+int verifyFile(const char* inputFile);
+int isLegacyFile(const char* inputFile);
 long getFileSize(const char* filename);
 
 
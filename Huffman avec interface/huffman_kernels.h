@@ -0,0 +1,249 @@
+#ifndef HUFFMAN_KERNELS_H
+#define HUFFMAN_KERNELS_H
+
+// Noyaux d'encodage et de décodage de Huffman, spécialisés à la compilation.
+// Ce fichier n'est inclus que par huffman.c : chaque noyau est une fonction générique
+// toujours inlinée, instanciée plus bas pour chaque couple (longueur maximale des codes,
+// nombre de flux entrelacés). Dans chaque instance, ces deux paramètres sont des
+// constantes : les boucles internes sont entièrement déroulées et les décalages et
+// masques sont des constantes.
+//
+// Les bits sont écrits et lus de poids fort en premier, comme dans le format d'origine.
+// Avec N flux, le symbole i est codé dans le flux i % N : au décodage, les N flux forment
+// des chaînes de dépendances indépendantes que le processeur exécute en parallèle.
+
+#include <stdint.h>
+#include <string.h>
+
+#define KERNEL_INLINE static inline __attribute__((always_inline))
+// Déroulement complet des boucles à nombre de tours constant (sans lui, GCC en -O2 les garde).
+// Les boucles sur les symboles d'un lot n'en ont pas : GCC les déroule déjà, et ignore l'annotation
+// avec les options de sanitizer de fuzz/instructions.txt
+#define KERNEL_UNROLL _Pragma("GCC unroll 16")
+
+// Symboles codés ou décodés entre deux accès mémoire : un rechargement garantit au moins
+// 57 bits valides et l'encodeur garde au plus 7 bits en attente, on s'en tient donc à 56 bits.
+#define SYMBOLS_PER_BATCH(maxLength) (56 / (maxLength))
+
+// Écriture d'un flux de bits : acc contient les bits en attente dans ses bits de poids faible
+struct BitWriter {
+    unsigned char* out;
+    uint64_t acc;
+    unsigned bits;
+};
+
+// Lecture d'un flux de bits : pos est la position courante en bits depuis data
+struct BitReader {
+    const unsigned char* data;
+    size_t size;
+    uint64_t pos;
+};
+
+static inline uint64_t load64be(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline void store64be(unsigned char* p, uint64_t v) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    memcpy(p, &v, sizeof(v));
+}
+
+KERNEL_INLINE void putBits(struct BitWriter* w, uint32_t code, unsigned length) {
+    w->acc = (w->acc << length) | code;
+    w->bits += length;
+}
+
+// Écrit les octets complets en attente (8 octets sont toujours écrits : la zone de sortie
+// doit avoir 8 octets de marge). L'octet incomplet est écrit mais reste en attente.
+KERNEL_INLINE void flushBits(struct BitWriter* w) {
+    store64be(w->out, (w->acc << 1) << (63 - w->bits));
+    w->out += w->bits >> 3;
+    w->bits &= 7;
+}
+
+// Lecture de 64 bits à partir de pos, sans déborder du flux (les bits au-delà valent 0)
+static inline uint64_t peekBitsSafe(const struct BitReader* r) {
+    uint64_t byte = r->pos >> 3;
+    if (byte + 8 <= r->size) {
+        return load64be(r->data + byte) << (r->pos & 7);
+    }
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v = (v << 8) | (byte + i < r->size ? r->data[byte + i] : 0);
+    }
+    return v << (r->pos & 7);
+}
+
+/**
+ * Fonction : encodeKernel
+ * Description : Encode size octets répartis sur streams flux. Par lot, chaque flux reçoit
+ *               SYMBOLS_PER_BATCH(maxLength) codes puis est vidé une seule fois.
+ * Paramètres :
+ * - const unsigned char* input, uint32_t size : Octets à encoder.
+ * - const uint32_t codes[], const unsigned char lengths[] : Code et longueur de chaque octet.
+ * - struct BitWriter w[] : Un écrivain par flux, out pointant sur une zone assez grande.
+ * - maxLength, streams : Constantes de l'instance.
+ */
+KERNEL_INLINE void encodeKernel(const unsigned char* input, uint32_t size,
+                                const uint32_t* codes, const unsigned char* lengths,
+                                struct BitWriter* w, const unsigned maxLength, const unsigned streams) {
+    const uint32_t batch = streams * SYMBOLS_PER_BATCH(maxLength);
+    uint32_t i = 0;
+
+    // Copie locale des écrivains : les écritures d'octets pourraient sinon modifier w, que le
+    // compilateur devrait relire à chaque code au lieu de le garder en registres
+    struct BitWriter local[4];
+    KERNEL_UNROLL
+    for (unsigned k = 0; k < streams; k++) {
+        local[k] = w[k];
+    }
+    for (; i + batch <= size; i += batch) {
+        const unsigned char* in = input + i;
+        for (unsigned j = 0; j < SYMBOLS_PER_BATCH(maxLength); j++) {
+            KERNEL_UNROLL
+            for (unsigned k = 0; k < streams; k++) {
+                putBits(&local[k], codes[in[j * streams + k]], lengths[in[j * streams + k]]);
+            }
+        }
+        KERNEL_UNROLL
+        for (unsigned k = 0; k < streams; k++) {
+            flushBits(&local[k]);
+        }
+    }
+    KERNEL_UNROLL
+    for (unsigned k = 0; k < streams; k++) {
+        w[k] = local[k];
+    }
+
+    // Fin du bloc, symbole par symbole
+    for (; i < size; i++) {
+        putBits(&w[i % streams], codes[input[i]], lengths[input[i]]);
+        flushBits(&w[i % streams]);
+    }
+    // L'octet incomplet de chaque flux est déjà écrit, complété par des zéros
+    KERNEL_UNROLL
+    for (unsigned k = 0; k < streams; k++) {
+        w[k].out += w[k].bits > 0;
+        w[k].bits = 0;
+    }
+}
+
+/**
+ * Fonction : decodeKernel
+ * Description : Décode count octets. L'octet o vient du flux o % streams, count doit donc
+ *               être un multiple de streams sauf au dernier appel d'un bloc.
+ *               Chaque entrée de table vaut (symbole << 8) | longueur et est indexée par les
+ *               tableBits prochains bits du flux.
+ * Paramètres :
+ * - struct BitReader r[] : Un lecteur par flux, avancé au fil du décodage.
+ * - unsigned char* output, uint32_t count : Destination et nombre d'octets à produire.
+ * - const uint16_t* table : Table de décodage de 2^tableBits entrées.
+ * - tableBits, streams : Constantes de l'instance (tableBits est aussi la longueur maximale).
+ */
+KERNEL_INLINE void decodeKernel(struct BitReader* r, unsigned char* output, uint32_t count,
+                                const uint16_t* table, const unsigned tableBits, const unsigned streams) {
+    const uint32_t batch = streams * SYMBOLS_PER_BATCH(tableBits);
+    uint32_t o = 0;
+
+    // Positions en variables locales, pour la même raison que dans encodeKernel
+    const unsigned char* data[4];
+    uint64_t end[4], pos[4];
+    KERNEL_UNROLL
+    for (unsigned k = 0; k < streams; k++) {
+        data[k] = r[k].data;
+        end[k] = r[k].size;
+        pos[k] = r[k].pos;
+    }
+    while (o + batch <= count) {
+        // Rechargement sans contrôle possible seulement si 8 octets restent dans chaque flux
+        int inside = 1;
+        KERNEL_UNROLL
+        for (unsigned k = 0; k < streams; k++) {
+            inside &= (pos[k] >> 3) + 8 <= end[k];
+        }
+        if (!inside) {
+            break;
+        }
+        uint64_t v[4];
+        KERNEL_UNROLL
+        for (unsigned k = 0; k < streams; k++) {
+            v[k] = load64be(data[k] + (pos[k] >> 3)) << (pos[k] & 7);
+        }
+        for (unsigned j = 0; j < SYMBOLS_PER_BATCH(tableBits); j++) {
+            KERNEL_UNROLL
+            for (unsigned k = 0; k < streams; k++) {
+                uint16_t entry = table[v[k] >> (64 - tableBits)];
+                output[o + j * streams + k] = (unsigned char)(entry >> 8);
+                v[k] <<= entry & 0xF;
+                pos[k] += entry & 0xF;
+            }
+        }
+        o += batch;
+    }
+    KERNEL_UNROLL
+    for (unsigned k = 0; k < streams; k++) {
+        r[k].pos = pos[k];
+    }
+
+    // Fin des flux : lectures bornées
+    for (; o < count; o++) {
+        struct BitReader* s = &r[o % streams];
+        uint16_t entry = table[peekBitsSafe(s) >> (64 - tableBits)];
+        output[o] = (unsigned char)(entry >> 8);
+        s->pos += entry & 0xF;
+    }
+}
+
+typedef void (*EncodeKernel)(const unsigned char* input, uint32_t size, const uint32_t* codes,
+                             const unsigned char* lengths, struct BitWriter* w);
+typedef void (*DecodeKernel)(struct BitReader* r, unsigned char* output, uint32_t count,
+                             const uint16_t* table);
+
+// Instanciation des noyaux pour une longueur maximale et un nombre de flux
+#define DEFINE_KERNELS(L, S) \
+    static void encode_L##L##_S##S(const unsigned char* input, uint32_t size, const uint32_t* codes, \
+                                   const unsigned char* lengths, struct BitWriter* w) { \
+        encodeKernel(input, size, codes, lengths, w, L, S); \
+    } \
+    static void decode_L##L##_S##S(struct BitReader* r, unsigned char* output, uint32_t count, \
+                                   const uint16_t* table) { \
+        decodeKernel(r, output, count, table, L, S); \
+    }
+
+DEFINE_KERNELS(11, 1) DEFINE_KERNELS(11, 2) DEFINE_KERNELS(11, 4)
+DEFINE_KERNELS(12, 1) DEFINE_KERNELS(12, 2) DEFINE_KERNELS(12, 4)
+DEFINE_KERNELS(15, 1) DEFINE_KERNELS(15, 2) DEFINE_KERNELS(15, 4)
+
+// Largeur de table (et longueur maximale couverte) de chaque classe de longueur
+static const unsigned kernelTableBits[3] = { 11, 12, 15 };
+
+static const EncodeKernel encodeKernels[3][3] = {
+    { encode_L11_S1, encode_L11_S2, encode_L11_S4 },
+    { encode_L12_S1, encode_L12_S2, encode_L12_S4 },
+    { encode_L15_S1, encode_L15_S2, encode_L15_S4 },
+};
+
+static const DecodeKernel decodeKernels[3][3] = {
+    { decode_L11_S1, decode_L11_S2, decode_L11_S4 },
+    { decode_L12_S1, decode_L12_S2, decode_L12_S4 },
+    { decode_L15_S1, decode_L15_S2, decode_L15_S4 },
+};
+
+// Classe de longueur d'une longueur maximale (au plus 15)
+static inline int kernelLengthClass(unsigned maxLength) {
+    return maxLength <= 11 ? 0 : maxLength <= 12 ? 1 : 2;
+}
+
+// Classe d'un nombre de flux (1, 2 ou 4)
+static inline int kernelStreamClass(unsigned streams) {
+    return streams == 1 ? 0 : streams == 2 ? 1 : 2;
+}
+
+#endif
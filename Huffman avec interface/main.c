@@ -1,107 +1,422 @@
 #include <gtk/gtk.h>
 #include <stdio.h>
+#include <string.h>
 #include "huffman.h"
-#include <time.h> // Pour benchmark du temps
 
-// Callback pour la sélection de fichier à compresser
-void on_compress_file(GtkWidget *widget, gpointer user_data) {
-    GtkWidget *dialog;
-    GtkWindow *parent = GTK_WINDOW(user_data); //utilisation de la librairie GTK (trouver dans le manuel)
+// Les opérations tournent dans un thread de travail pour que la fenêtre reste réactive.
+// Le thread principal (GTK) et le thread de travail ne partagent que la file des travaux
+// et les demandes d'annulation ; tout le reste passe par g_idle_add vers le thread principal.
 
-    //texte de l'interface graphique
-    dialog = gtk_file_chooser_dialog_new("Choisir un fichier à compresser", parent,
-                                         GTK_FILE_CHOOSER_ACTION_OPEN,
-                                         "_Annuler", GTK_RESPONSE_CANCEL,
-                                         "_Ouvrir", GTK_RESPONSE_ACCEPT,
-                                         NULL);
+#define PROGRESS_INTERVAL_US 100000 // Au plus 10 mises à jour de la barre par seconde
 
-    //si on clique sur ouvrir
-    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
-        char *filename;
-        GtkFileChooser *chooser = GTK_FILE_CHOOSER(dialog);
-        filename = gtk_file_chooser_get_filename(chooser);
+enum JobType { JOB_COMPRESS, JOB_DECOMPRESS, JOB_VERIFY };
+
+// Un travail en file : créé par le thread principal, exécuté par le thread de travail,
+// puis rendu au thread principal (onJobFinished) qui le libère.
+struct Job {
+    gint id;                            // Numéro d'ordre, à partir de 1 ; les travaux finissent dans cet ordre
+    enum JobType type;
+    char* input;
+    char* output;                       // NULL pour une vérification
+    unsigned long long inputSize;
+    unsigned long long outputSize;
+    gint64 startTime;
+    gint64 lastReport;
+    gint64 elapsed;
+    int result;
+};
 
-        clock_t start = clock();
+// Avancement transmis au thread principal (copie, le travail peut être libéré entre-temps)
+struct ProgressUpdate {
+    unsigned long long processed;
+    unsigned long long total;
+    gint64 elapsed;
+};
+
+// Widgets et état de la fenêtre, utilisés uniquement depuis le thread principal
+static struct {
+    GtkWidget* window;
+    GtkWidget* progressBar;
+    GtkWidget* statusLabel;
+    GtkWidget* resultLabel;
+    GtkWidget* queueLabel;
+    GtkWidget* cancelButton;
+    int pendingJobs;                    // Travaux en file ou en cours
+    gint lastJobId;                     // Numéro du dernier travail mis en file
+    gint finishedJobs;                  // Travaux terminés : le suivant est celui affiché en cours
+} app;
+
+static GAsyncQueue* jobQueue;           // File des travaux (struct Job*), terminée par stopJob
+static GThread* worker;                 // Thread de travail, attendu avant de quitter
+static struct Job stopJob;              // Sentinelle : le thread de travail s'arrête en la retirant
+static gint cancelledJob;               // Numéro du travail dont l'annulation est demandée, accès atomiques
+static gint shuttingDown;               // Fermeture de la fenêtre : tous les travaux sont annulés
+
+// Annulation demandée pour ce travail (thread de travail)
+static int jobCancelled(const struct Job* job) {
+    return g_atomic_int_get(&shuttingDown) || g_atomic_int_get(&cancelledJob) == job->id;
+}
 
-        // On appelle la fonction de compression ici
-        compressFile(filename, "compressed.bin");
-        clock_t end = clock();
+static void updateQueueLabel(void) {
+    char text[64];
+    if (app.pendingJobs > 1)
+        snprintf(text, sizeof(text), "En attente : %d", app.pendingJobs - 1);
+    else
+        text[0] = '\0';
+    gtk_label_set_text(GTK_LABEL(app.queueLabel), text);
+    gtk_widget_set_sensitive(app.cancelButton, app.pendingJobs > 0);
+}
 
-        double timeTaken = (double)(end - start) / CLOCKS_PER_SEC;
-        printf("Temps d'exécution : %.2f secondes\n", timeTaken);
+static const char* baseName(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
 
-        g_print("Fichier compressé avec succés.\n");
+/**
+ * Fonction : onProgress
+ * Description : Affiche l'avancement du travail en cours (thread principal) : fraction traitée,
+ *               débit en Mo/s et temps restant estimé.
+ * Paramètres :
+ * - gpointer data : struct ProgressUpdate*, libérée ici.
+ * Retour :
+ * - gboolean : G_SOURCE_REMOVE, la source n'est appelée qu'une fois.
+ */
+static gboolean onProgress(gpointer data) {
+    struct ProgressUpdate* update = data;
+    double seconds = update->elapsed / 1e6;
+    double rate = seconds > 0 ? update->processed / seconds : 0;
+    double fraction = update->total ? (double)update->processed / update->total : 0;
+    if (fraction > 1)
+        fraction = 1;
 
-        g_free(filename);
+    char text[128];
+    if (rate > 0) {
+        double remaining = (update->total > update->processed ? update->total - update->processed : 0) / rate;
+        snprintf(text, sizeof(text), "%.0f %% - %.1f Mo/s - reste %.0f s",
+                 fraction * 100, rate / (1024 * 1024), remaining);
+    } else {
+        snprintf(text, sizeof(text), "%.0f %%", fraction * 100);
     }
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(app.progressBar), fraction);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(app.progressBar), text);
 
-    gtk_widget_destroy(dialog);
+    g_free(update);
+    return G_SOURCE_REMOVE;
 }
 
-// Callback pour la sélection de fichier à décompresser (meme logique que pour compresser)
-void on_decompress_file(GtkWidget *widget, gpointer user_data) {
-    GtkWidget *dialog;
-    GtkWindow *parent = GTK_WINDOW(user_data);
+/**
+ * Fonction : onJobStarted
+ * Description : Indique dans la fenêtre quel fichier est en cours de traitement (thread principal).
+ * Paramètres :
+ * - gpointer data : struct Job* en cours, seuls ses champs constants sont lus.
+ * Retour :
+ * - gboolean : G_SOURCE_REMOVE.
+ */
+static gboolean onJobStarted(gpointer data) {
+    struct Job* job = data;
+    static const char* verbs[] = { "Compression", "Décompression", "Vérification" };
+    char* text = g_strdup_printf("%s de %s...", verbs[job->type], baseName(job->input));
+    gtk_label_set_text(GTK_LABEL(app.statusLabel), text);
+    g_free(text);
 
-    dialog = gtk_file_chooser_dialog_new("Choisir un fichier à decompresser", parent,
-                                         GTK_FILE_CHOOSER_ACTION_OPEN,
-                                         "_Annuler", GTK_RESPONSE_CANCEL,
-                                         "_Ouvrir", GTK_RESPONSE_ACCEPT,
-                                         NULL);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(app.progressBar), 0);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(app.progressBar), job->type == JOB_VERIFY ? "Vérification..." : "0 %");
+    return G_SOURCE_REMOVE;
+}
 
-    //si on clique sur ouvrir
-    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
-        char *filename;
-        GtkFileChooser *chooser = GTK_FILE_CHOOSER(dialog);
-        filename = gtk_file_chooser_get_filename(chooser);
+/**
+ * Fonction : onJobFinished
+ * Description : Affiche le résultat d'un travail terminé (taux de compression, durée, débit)
+ *               puis libère le travail (thread principal).
+ * Paramètres :
+ * - gpointer data : struct Job* terminé, libéré ici.
+ * Retour :
+ * - gboolean : G_SOURCE_REMOVE.
+ */
+static gboolean onJobFinished(gpointer data) {
+    struct Job* job = data;
+    double seconds = job->elapsed / 1e6;
+    double rate = seconds > 0 ? job->inputSize / seconds / (1024 * 1024) : 0;
+    char* text;
 
-        clock_t start = clock();
+    if (job->result == 1) {
+        text = g_strdup_printf("%s : opération annulée.", baseName(job->input));
+    } else if (job->result != 0) {
+        text = g_strdup_printf("%s : échec (fichier corrompu ou illisible).", baseName(job->input));
+    } else if (job->type == JOB_COMPRESS) {
+        text = g_strdup_printf("%s : %llu -> %llu octets (%.2f %%), %.2f s, %.1f Mo/s",
+                               baseName(job->output), job->inputSize, job->outputSize,
+                               job->inputSize ? 100.0 * job->outputSize / job->inputSize : 0.0,
+                               seconds, rate);
+    } else if (job->type == JOB_DECOMPRESS) {
+        text = g_strdup_printf("%s : %llu octets restaurés depuis %llu (%.2f %%), %.2f s, %.1f Mo/s",
+                               baseName(job->output), job->outputSize, job->inputSize,
+                               job->outputSize ? 100.0 * job->inputSize / job->outputSize : 0.0,
+                               seconds, rate);
+    } else {
+        text = g_strdup_printf("%s : fichier intact, %.2f s", baseName(job->input), seconds);
+    }
+    gtk_label_set_text(GTK_LABEL(app.resultLabel), text);
+    g_print("%s\n", text);
+    g_free(text);
 
-        // Appel de la fonction de décompression ici
-        decompressFile(filename, "output.txt");
-        clock_t end = clock();
+    app.pendingJobs--;
+    app.finishedJobs++;
+    updateQueueLabel();
+    if (app.pendingJobs == 0) {
+        gtk_label_set_text(GTK_LABEL(app.statusLabel), "Prêt.");
+        gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(app.progressBar), job->result == 0 ? 1 : 0);
+        gtk_progress_bar_set_text(GTK_PROGRESS_BAR(app.progressBar), job->result == 0 ? "Terminé" : "");
+    }
+
+    g_free(job->input);
+    g_free(job->output);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
 
-        double timeTaken = (double)(end - start) / CLOCKS_PER_SEC;
-        printf("Temps d'exécution : %.2f secondes\n", timeTaken);
+/**
+ * Fonction : reportProgress
+ * Description : ProgressCallback des codecs, appelée dans le thread de travail. Limite les
+ *               mises à jour de la fenêtre à une toutes les PROGRESS_INTERVAL_US.
+ * Paramètres :
+ * - unsigned long long processed : Octets d'entrée traités.
+ * - void* userData : struct Job* en cours.
+ * Retour :
+ * - int : Non nul si l'utilisateur a demandé l'annulation.
+ */
+static int reportProgress(unsigned long long processed, void* userData) {
+    struct Job* job = userData;
+    gint64 now = g_get_monotonic_time();
+    if (now - job->lastReport >= PROGRESS_INTERVAL_US) {
+        struct ProgressUpdate* update = g_new(struct ProgressUpdate, 1);
+        update->processed = processed;
+        update->total = job->inputSize;
+        update->elapsed = now - job->startTime;
+        job->lastReport = now;
+        g_idle_add(onProgress, update);
+    }
+    return jobCancelled(job);
+}
 
-        g_print("Fichier décompressé avec succés.\n");
+/**
+ * Fonction : runJob
+ * Description : Exécute un travail de compression ou de décompression dans le thread de travail.
+ *               La sortie partielle d'un travail annulé ou en échec est supprimée.
+ * Paramètres :
+ * - struct Job* job : Travail à exécuter ; result vaut 0 (succès), 1 (annulé) ou -1 (erreur).
+ */
+static void runJob(struct Job* job) {
+    if (jobCancelled(job)) {
+        job->result = 1; // Annulé avant d'avoir commencé
+        return;
+    }
+    if (job->type == JOB_VERIFY) {
+        job->result = verifyFile(job->input);
+        return;
+    }
 
-        g_free(filename);
+    FILE* inFile = fopen(job->input, "rb");
+    if (!inFile) {
+        perror("Échec de l'ouverture du fichier d'entrée");
+        job->result = -1;
+        return;
+    }
+    FILE* outFile = fopen(job->output, "wb");
+    if (!outFile) {
+        perror("Échec de l'ouverture du fichier de sortie");
+        fclose(inFile);
+        job->result = -1;
+        return;
+    }
+
+    unsigned long long processed = 0;
+    if (job->type == JOB_COMPRESS)
+        job->result = compressStream(inFile, outFile, &processed, reportProgress, job);
+    else
+        job->result = decompressStream(inFile, outFile, &processed, reportProgress, job);
+
+    job->outputSize = (unsigned long long)ftell(outFile);
+    fclose(inFile);
+    fclose(outFile);
+
+    if (job->result != 0) {
+        if (jobCancelled(job))
+            job->result = 1;
+        remove(job->output);
+    }
+}
+
+// Thread de travail : exécute les travaux un par un, dans l'ordre de la file, jusqu'à stopJob
+static gpointer workerThread(gpointer data) {
+    (void)data;
+    for (;;) {
+        struct Job* job = g_async_queue_pop(jobQueue);
+        if (job == &stopJob)
+            break;
+        job->startTime = g_get_monotonic_time();
+        job->lastReport = job->startTime;
+        g_idle_add(onJobStarted, job);
+
+        runJob(job);
+
+        job->elapsed = g_get_monotonic_time() - job->startTime;
+        g_idle_add(onJobFinished, job);
+    }
+    return NULL;
+}
+
+/**
+ * Fonction : enqueueJob
+ * Description : Ajoute un travail à la file. Le nom de sortie est dérivé de l'entrée pour que
+ *               plusieurs travaux en file ne s'écrasent pas : "x" -> "x.bin" à la compression,
+ *               "x.bin" -> "x.out" à la décompression.
+ * Paramètres :
+ * - enum JobType type : Nature du travail.
+ * - const char* filename : Fichier d'entrée.
+ */
+static void enqueueJob(enum JobType type, const char* filename) {
+    struct Job* job = g_new0(struct Job, 1);
+    job->id = ++app.lastJobId;
+    job->type = type;
+    job->input = g_strdup(filename);
+    long size = getFileSize(filename);
+    job->inputSize = size > 0 ? (unsigned long long)size : 0;
+
+    if (type == JOB_COMPRESS) {
+        job->output = g_strconcat(filename, ".bin", NULL);
+    } else if (type == JOB_DECOMPRESS) {
+        size_t length = strlen(filename);
+        if (g_str_has_suffix(filename, ".bin"))
+            length -= 4;
+        job->output = g_strdup_printf("%.*s.out", (int)length, filename);
+    }
+
+    app.pendingJobs++;
+    updateQueueLabel();
+    g_async_queue_push(jobQueue, job);
+}
+
+/**
+ * Fonction : chooseFiles
+ * Description : Ouvre un sélecteur de fichiers (sélection multiple) et met un travail en file
+ *               pour chaque fichier choisi.
+ * Paramètres :
+ * - const char* title : Titre de la boîte de dialogue.
+ * - enum JobType type : Nature des travaux à créer.
+ */
+static void chooseFiles(const char* title, enum JobType type) {
+    GtkWidget* dialog = gtk_file_chooser_dialog_new(title, GTK_WINDOW(app.window),
+                                                    GTK_FILE_CHOOSER_ACTION_OPEN,
+                                                    "_Annuler", GTK_RESPONSE_CANCEL,
+                                                    "_Ouvrir", GTK_RESPONSE_ACCEPT,
+                                                    NULL);
+    gtk_file_chooser_set_select_multiple(GTK_FILE_CHOOSER(dialog), TRUE);
+
+    //si on clique sur ouvrir
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        GSList* filenames = gtk_file_chooser_get_filenames(GTK_FILE_CHOOSER(dialog));
+        for (GSList* it = filenames; it; it = it->next)
+            enqueueJob(type, it->data);
+        g_slist_free_full(filenames, g_free);
     }
 
     gtk_widget_destroy(dialog);
 }
 
+// Callback pour la sélection de fichiers à compresser
+void on_compress_file(GtkWidget *widget, gpointer user_data) {
+    chooseFiles("Choisir les fichiers à compresser", JOB_COMPRESS);
+}
+
+// Callback pour la sélection de fichiers à décompresser
+void on_decompress_file(GtkWidget *widget, gpointer user_data) {
+    chooseFiles("Choisir les fichiers à decompresser", JOB_DECOMPRESS);
+}
+
+// Callback pour la vérification de fichiers compressés, sans rien écrire
+void on_verify_file(GtkWidget *widget, gpointer user_data) {
+    chooseFiles("Choisir les fichiers à vérifier", JOB_VERIFY);
+}
+
+// Callback du bouton Annuler : interrompt le travail affiché en cours (le plus ancien non terminé),
+// même s'il n'a pas encore commencé ; les suivants restent en file
+void on_cancel(GtkWidget *widget, gpointer user_data) {
+    if (app.pendingJobs > 0)
+        g_atomic_int_set(&cancelledJob, app.finishedJobs + 1);
+}
+
 int main(int argc, char *argv[]) {
-    GtkWidget *window;
     GtkWidget *grid;
     GtkWidget *compress_button;
     GtkWidget *decompress_button;
+    GtkWidget *verify_button;
 
     gtk_init(&argc, &argv);
 
     // Créer la fenêtre principale
-    window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-    gtk_window_set_title(GTK_WINDOW(window), "Compression de Huffman");
-    gtk_window_set_default_size(GTK_WINDOW(window), 300, 100);
-    g_signal_connect(window, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+    app.window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_title(GTK_WINDOW(app.window), "Compression de Huffman");
+    gtk_window_set_default_size(GTK_WINDOW(app.window), 480, 160);
+    g_signal_connect(app.window, "destroy", G_CALLBACK(gtk_main_quit), NULL);
 
-    // Créer une grille pour les boutons
+    // Créer une grille pour les boutons et l'affichage de l'avancement
     grid = gtk_grid_new();
-    gtk_container_add(GTK_CONTAINER(window), grid);
+    gtk_grid_set_row_spacing(GTK_GRID(grid), 4);
+    gtk_container_add(GTK_CONTAINER(app.window), grid);
 
     // Bouton pour compresser un fichier
     compress_button = gtk_button_new_with_label("Compresser le fichier");
-    g_signal_connect(compress_button, "clicked", G_CALLBACK(on_compress_file), window);
+    g_signal_connect(compress_button, "clicked", G_CALLBACK(on_compress_file), NULL);
     gtk_grid_attach(GTK_GRID(grid), compress_button, 0, 0, 1, 1);
 
     // Bouton pour décompresser un fichier
     decompress_button = gtk_button_new_with_label("Decompresser le fichier");
-    g_signal_connect(decompress_button, "clicked", G_CALLBACK(on_decompress_file), window);
+    g_signal_connect(decompress_button, "clicked", G_CALLBACK(on_decompress_file), NULL);
     gtk_grid_attach(GTK_GRID(grid), decompress_button, 1, 0, 1, 1);
 
-    gtk_widget_show_all(window);
+    // Bouton pour vérifier un fichier compressé
+    verify_button = gtk_button_new_with_label("Vérifier le fichier");
+    g_signal_connect(verify_button, "clicked", G_CALLBACK(on_verify_file), NULL);
+    gtk_grid_attach(GTK_GRID(grid), verify_button, 2, 0, 1, 1);
+
+    // Bouton pour annuler le travail en cours
+    app.cancelButton = gtk_button_new_with_label("Annuler");
+    g_signal_connect(app.cancelButton, "clicked", G_CALLBACK(on_cancel), NULL);
+    gtk_grid_attach(GTK_GRID(grid), app.cancelButton, 3, 0, 1, 1);
+
+    // Avancement : fichier en cours, barre (%, Mo/s, temps restant), file, dernier résultat
+    app.statusLabel = gtk_label_new("Prêt.");
+    gtk_widget_set_halign(app.statusLabel, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(grid), app.statusLabel, 0, 1, 4, 1);
+
+    app.progressBar = gtk_progress_bar_new();
+    gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(app.progressBar), TRUE);
+    gtk_widget_set_hexpand(app.progressBar, TRUE);
+    gtk_grid_attach(GTK_GRID(grid), app.progressBar, 0, 2, 4, 1);
+
+    app.queueLabel = gtk_label_new("");
+    gtk_widget_set_halign(app.queueLabel, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(grid), app.queueLabel, 0, 3, 4, 1);
+
+    app.resultLabel = gtk_label_new("");
+    gtk_widget_set_halign(app.resultLabel, GTK_ALIGN_START);
+    gtk_label_set_selectable(GTK_LABEL(app.resultLabel), TRUE);
+    gtk_grid_attach(GTK_GRID(grid), app.resultLabel, 0, 4, 4, 1);
+
+    // Le thread de travail vit aussi longtemps que la fenêtre
+    jobQueue = g_async_queue_new();
+    worker = g_thread_new("travail", workerThread, NULL);
+
+    gtk_widget_show_all(app.window);
+    updateQueueLabel();
     gtk_main();
 
+    // Fenêtre fermée : le travail en cours est annulé (sa sortie partielle supprimée), ceux en file
+    // sont abandonnés, et le thread de travail est attendu avant de quitter
+    g_atomic_int_set(&shuttingDown, 1);
+    g_async_queue_push(jobQueue, &stopJob);
+    g_thread_join(worker);
+    g_async_queue_unref(jobQueue);
     return 0;
 }
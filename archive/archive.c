@@ -0,0 +1,589 @@
+/* archive.c - Création, listage, extraction et vérification des archives multi-fichiers.
+ * Les fichiers sont compressés en parallèle par un groupe de threads ; chaque thread écrit
+ * le résultat dans l'archive dès qu'il est prêt, le répertoire central garde l'ordre d'origine. */
+#include "archive.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "../commun/crc32c.h"
+#include "../Huffman avec interface/huffman.h"
+#include "../compression lzw/table.h"
+
+static const char* noms_codecs[] = {"brut", "huffman", "lzw"}; // Noms affichés par lister_archive
+
+// État partagé par les threads de compression
+struct TravailArchive {
+    char** fichiers;
+    int nb_fichiers;
+    int codec;                       // Codec demandé
+    int prochain;                    // Index du prochain fichier à compresser
+    FILE* archive;
+    uint64_t decalage;               // Position de la prochaine écriture dans l'archive
+    struct EntreeArchive* entrees;   // Une entrée par fichier, dans l'ordre d'origine
+    int erreurs;
+    pthread_mutex_t verrou;          // Protège prochain, archive, decalage et erreurs
+};
+
+/**
+ * Fonction : nom_sur
+ * Description : Refuse les noms qui sortiraient du dossier d'extraction (chemin absolu, "..").
+ * Paramètres :
+ * - nom : Nom lu dans l'archive.
+ * Retourne : 1 si le nom peut être extrait, 0 sinon.
+ */
+static int nom_sur(const char* nom) {
+    if (nom[0] == '\0' || nom[0] == '/') {
+        return 0;
+    }
+    for (const char* p = nom; *p; ) {
+        const char* fin = strchr(p, '/');
+        size_t longueur = fin ? (size_t)(fin - p) : strlen(p);
+        if (longueur == 2 && p[0] == '.' && p[1] == '.') {
+            return 0;
+        }
+        p += longueur + (fin ? 1 : 0);
+    }
+    return 1;
+}
+
+/**
+ * Fonction : nom_dans_archive
+ * Description : Donne le nom sous lequel un fichier est rangé : chemin relatif, sans "./" ni "/" en tête.
+ *               Comme avec tar, tout ce qui précède le dernier composant ".." est retiré
+ *               ("../src/a.txt" devient "src/a.txt"), pour que le nom reste extractible (voir nom_sur).
+ * Paramètres :
+ * - chemin : Chemin du fichier tel que donné sur la ligne de commande.
+ * Retourne : Un pointeur à l'intérieur de chemin.
+ */
+static const char* nom_dans_archive(const char* chemin) {
+    for (const char* p = chemin; *p; ) {
+        const char* fin = strchr(p, '/');
+        size_t longueur = fin ? (size_t)(fin - p) : strlen(p);
+        if (longueur == 2 && p[0] == '.' && p[1] == '.') {
+            chemin = p + longueur;
+        }
+        p += longueur + (fin ? 1 : 0);
+    }
+    while (*chemin == '/' || (chemin[0] == '.' && chemin[1] == '/')) {
+        chemin += (*chemin == '/') ? 1 : 2;
+    }
+    return chemin;
+}
+
+/**
+ * Fonction : compresser_en_memoire
+ * Description : Compresse un fichier entier en mémoire avec le codec demandé. Si LZW échoue,
+ *               le fichier est compressé avec Huffman. Si la compression
+ *               ne fait rien gagner (petits fichiers, données aléatoires), le fichier est stocké tel quel.
+ * Paramètres :
+ * - chemin : Fichier à compresser.
+ * - codec : Codec demandé (CODEC_HUFFMAN ou CODEC_LZW).
+ * - donnees, taille : Reçoivent les octets à écrire dans l'archive (à libérer avec free).
+ * - entree : Reçoit le codec retenu, les tailles et le CRC (le décalage reste à remplir).
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur.
+ */
+static int compresser_en_memoire(const char* chemin, int codec, unsigned char** donnees, size_t* taille,
+                                 struct EntreeArchive* entree) {
+    FILE* fichier = fopen(chemin, "rb");
+    if (!fichier) {
+        fprintf(stderr, "Ne peut pas ouvrir %s : %s\n", chemin, strerror(errno));
+        return -1;
+    }
+
+    char* tampon = NULL;
+    size_t longueur = 0;
+    unsigned long long taille_originale = 0;
+    int resultat = -1;
+
+    if (codec == CODEC_LZW) {
+        FILE* memoire = open_memstream(&tampon, &longueur);
+        long int compte_entrees, compte_sorties;
+        resultat = memoire ? compresser_flux_lzw(fichier, memoire, &compte_entrees, &compte_sorties) : -1;
+        if (memoire) {
+            fclose(memoire);
+        }
+        taille_originale = (unsigned long long)compte_entrees;
+        if (resultat != 0) {
+            // Échec de LZW : repli sur Huffman
+            free(tampon);
+            tampon = NULL;
+            rewind(fichier);
+            codec = CODEC_HUFFMAN;
+        }
+    }
+    if (codec == CODEC_HUFFMAN) {
+        FILE* memoire = open_memstream(&tampon, &longueur);
+        resultat = memoire ? compressStream(fichier, memoire, &taille_originale, NULL, NULL) : -1;
+        if (memoire) {
+            fclose(memoire);
+        }
+    }
+
+    if (resultat == 0 && longueur >= taille_originale) {
+        // Rien à gagner : on stocke les octets bruts
+        free(tampon);
+        tampon = malloc(taille_originale > 0 ? taille_originale : 1);
+        rewind(fichier);
+        longueur = tampon ? fread(tampon, 1, taille_originale, fichier) : 0;
+        resultat = (tampon && longueur == taille_originale) ? 0 : -1;
+        codec = CODEC_STOCKE;
+    }
+    fclose(fichier);
+
+    if (resultat != 0) {
+        fprintf(stderr, "Échec de la compression de %s\n", chemin);
+        free(tampon);
+        return -1;
+    }
+
+    entree->taille_compressee = longueur;
+    entree->taille_originale = taille_originale;
+    entree->crc = crc32c_maj(CRC32C_INIT, tampon, longueur);
+    entree->codec = (uint8_t)codec;
+    *donnees = (unsigned char*)tampon;
+    *taille = longueur;
+    return 0;
+}
+
+/**
+ * Fonction : thread_compression
+ * Description : Boucle d'un thread du groupe : prend le prochain fichier, le compresse en mémoire
+ *               sans verrou, puis l'ajoute à la suite de l'archive sous le verrou.
+ * Paramètres :
+ * - argument : La struct TravailArchive partagée.
+ * Retourne : NULL.
+ */
+static void* thread_compression(void* argument) {
+    struct TravailArchive* travail = argument;
+
+    for (;;) {
+        pthread_mutex_lock(&travail->verrou);
+        int index = travail->prochain++;
+        pthread_mutex_unlock(&travail->verrou);
+        if (index >= travail->nb_fichiers) {
+            return NULL;
+        }
+
+        struct EntreeArchive* entree = &travail->entrees[index];
+        unsigned char* donnees;
+        size_t taille;
+        int resultat = -1;
+        if (!nom_sur(nom_dans_archive(travail->fichiers[index]))) {
+            // L'extraction refuserait ce nom : inutile d'archiver le fichier
+            fprintf(stderr, "%s : nom impossible à ranger dans l'archive\n", travail->fichiers[index]);
+        } else {
+            resultat = compresser_en_memoire(travail->fichiers[index], travail->codec, &donnees, &taille, entree);
+        }
+
+        pthread_mutex_lock(&travail->verrou);
+        if (resultat == 0) {
+            entree->decalage = travail->decalage;
+            if (fwrite(donnees, 1, taille, travail->archive) != taille) {
+                travail->erreurs++;
+            }
+            travail->decalage += taille;
+        } else {
+            travail->erreurs++;
+        }
+        pthread_mutex_unlock(&travail->verrou);
+
+        if (resultat == 0) {
+            free(donnees);
+        }
+    }
+}
+
+/**
+ * Fonction : creer_archive
+ * Description : Crée une archive à partir d'une liste de fichiers, compressés en parallèle.
+ * Paramètres :
+ * - nom_archive : Fichier archive à créer.
+ * - fichiers : Chemins des fichiers à archiver.
+ * - nb_fichiers : Nombre de fichiers.
+ * - codec : CODEC_HUFFMAN ou CODEC_LZW.
+ * - nb_threads : Nombre de threads de compression (au moins 1).
+ * Retourne : 0 en cas de succès, -1 si un fichier n'a pas pu être archivé.
+ */
+int creer_archive(const char* nom_archive, char** fichiers, int nb_fichiers, int codec, int nb_threads) {
+    struct TravailArchive travail = {0};
+    travail.fichiers = fichiers;
+    travail.nb_fichiers = nb_fichiers;
+    travail.codec = codec;
+    travail.entrees = calloc(nb_fichiers > 0 ? nb_fichiers : 1, sizeof(struct EntreeArchive));
+    travail.archive = fopen(nom_archive, "wb");
+    if (!travail.entrees || !travail.archive) {
+        perror("Ne peut pas créer l'archive");
+        free(travail.entrees);
+        if (travail.archive) {
+            fclose(travail.archive);
+        }
+        return -1;
+    }
+    pthread_mutex_init(&travail.verrou, NULL);
+
+    fwrite(ARCHIVE_MAGIQUE, 1, 4, travail.archive);
+    travail.decalage = 4;
+
+    // Lancement du groupe de threads
+    if (nb_threads < 1) {
+        nb_threads = 1;
+    }
+    if (nb_threads > nb_fichiers) {
+        nb_threads = nb_fichiers > 0 ? nb_fichiers : 1;
+    }
+    pthread_t* threads = malloc(nb_threads * sizeof(pthread_t));
+    int lances = 0;
+    while (threads && lances < nb_threads && pthread_create(&threads[lances], NULL, thread_compression, &travail) == 0) {
+        lances++;
+    }
+    if (lances == 0) {
+        thread_compression(&travail); // Pas de thread disponible : compression dans le thread courant
+    }
+    for (int i = 0; i < lances; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&travail.verrou);
+
+    // Répertoire central, dans l'ordre de la ligne de commande
+    struct PiedArchive pied = {0};
+    pied.decalage_repertoire = travail.decalage;
+    uint32_t crc = CRC32C_INIT;
+    for (int i = 0; i < nb_fichiers; i++) {
+        const char* nom = nom_dans_archive(fichiers[i]);
+        struct EntreeArchive* entree = &travail.entrees[i];
+        size_t longueur = strlen(nom);
+        if (entree->decalage == 0) {
+            continue; // Fichier en erreur, déjà signalé
+        }
+        entree->longueur_nom = (uint16_t)(longueur > UINT16_MAX ? UINT16_MAX : longueur);
+        fwrite(entree, sizeof(*entree), 1, travail.archive);
+        fwrite(nom, 1, entree->longueur_nom, travail.archive);
+        crc = crc32c_maj(crc, entree, sizeof(*entree));
+        crc = crc32c_maj(crc, nom, entree->longueur_nom);
+        pied.taille_repertoire += sizeof(*entree) + entree->longueur_nom;
+        pied.nb_entrees++;
+    }
+    pied.crc_repertoire = crc;
+    memcpy(pied.magique, ARCHIVE_MAGIQUE, 4);
+    fwrite(&pied, sizeof(pied), 1, travail.archive);
+
+    int erreur_ecriture = fclose(travail.archive) != 0;
+    free(travail.entrees);
+
+    printf("Archive %s : %u fichiers, %d threads\n", nom_archive, pied.nb_entrees, lances > 0 ? lances : 1);
+    return (travail.erreurs || erreur_ecriture) ? -1 : 0;
+}
+
+/**
+ * Fonction : lire_repertoire
+ * Description : Charge le répertoire central à partir du pied de l'archive, sans lire les données.
+ *               L'archive n'est pas supposée fiable : tailles, noms et CRC du répertoire sont contrôlés.
+ * Paramètres :
+ * - archive : Archive ouverte en lecture.
+ * - repertoire : Reçoit les entrées et les noms (à libérer avec liberer_repertoire).
+ * Retourne : 0 en cas de succès, -1 si l'archive est invalide.
+ */
+int lire_repertoire(FILE* archive, struct RepertoireArchive* repertoire) {
+    struct PiedArchive pied;
+    memset(repertoire, 0, sizeof(*repertoire));
+
+    if (fseek(archive, 0, SEEK_END) != 0) {
+        return -1;
+    }
+    long taille_archive = ftell(archive);
+    if (taille_archive < (long)(4 + sizeof(pied)) ||
+        fseek(archive, -(long)sizeof(pied), SEEK_END) != 0 ||
+        fread(&pied, sizeof(pied), 1, archive) != 1 ||
+        memcmp(pied.magique, ARCHIVE_MAGIQUE, 4) != 0) {
+        fprintf(stderr, "Archive invalide ou tronquée : pied introuvable\n");
+        return -1;
+    }
+    uint64_t fin_donnees = (uint64_t)taille_archive - sizeof(pied);
+    if (pied.decalage_repertoire < 4 || pied.decalage_repertoire > fin_donnees ||
+        pied.taille_repertoire != fin_donnees - pied.decalage_repertoire ||
+        pied.nb_entrees > pied.taille_repertoire / sizeof(struct EntreeArchive)) {
+        fprintf(stderr, "Archive invalide : répertoire central hors limites\n");
+        return -1;
+    }
+
+    unsigned char* brut = malloc(pied.taille_repertoire > 0 ? pied.taille_repertoire : 1);
+    if (!brut || fseek(archive, (long)pied.decalage_repertoire, SEEK_SET) != 0 ||
+        fread(brut, 1, pied.taille_repertoire, archive) != pied.taille_repertoire ||
+        crc32c_maj(CRC32C_INIT, brut, pied.taille_repertoire) != pied.crc_repertoire) {
+        fprintf(stderr, "Archive corrompue : CRC32C du répertoire central incorrect\n");
+        free(brut);
+        return -1;
+    }
+
+    repertoire->entrees = calloc(pied.nb_entrees > 0 ? pied.nb_entrees : 1, sizeof(struct EntreeArchive));
+    repertoire->noms = calloc(pied.nb_entrees > 0 ? pied.nb_entrees : 1, sizeof(char*));
+    if (!repertoire->entrees || !repertoire->noms) {
+        free(brut);
+        liberer_repertoire(repertoire);
+        return -1;
+    }
+
+    size_t position = 0;
+    for (uint32_t i = 0; i < pied.nb_entrees; i++) {
+        struct EntreeArchive* entree = &repertoire->entrees[i];
+        if (pied.taille_repertoire - position < sizeof(*entree)) {
+            break;
+        }
+        memcpy(entree, brut + position, sizeof(*entree));
+        position += sizeof(*entree);
+        if (pied.taille_repertoire - position < entree->longueur_nom || entree->codec > CODEC_LZW ||
+            entree->decalage < 4 || entree->decalage > pied.decalage_repertoire ||
+            entree->taille_compressee > pied.decalage_repertoire - entree->decalage) {
+            break;
+        }
+        repertoire->noms[i] = malloc(entree->longueur_nom + 1);
+        if (!repertoire->noms[i]) {
+            break;
+        }
+        memcpy(repertoire->noms[i], brut + position, entree->longueur_nom);
+        repertoire->noms[i][entree->longueur_nom] = '\0';
+        position += entree->longueur_nom;
+        repertoire->nb_entrees++;
+    }
+    free(brut);
+
+    if (repertoire->nb_entrees != pied.nb_entrees) {
+        fprintf(stderr, "Archive invalide : entrée %u du répertoire central malformée\n", repertoire->nb_entrees + 1);
+        liberer_repertoire(repertoire);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Fonction : liberer_repertoire
+ * Description : Libère un répertoire chargé par lire_repertoire.
+ * Paramètres :
+ * - repertoire : Le répertoire à libérer.
+ */
+void liberer_repertoire(struct RepertoireArchive* repertoire) {
+    if (repertoire->noms) {
+        for (uint32_t i = 0; i < repertoire->nb_entrees; i++) {
+            free(repertoire->noms[i]);
+        }
+    }
+    free(repertoire->noms);
+    free(repertoire->entrees);
+    memset(repertoire, 0, sizeof(*repertoire));
+}
+
+/**
+ * Fonction : ouvrir_archive
+ * Description : Ouvre une archive et charge son répertoire central.
+ * Paramètres :
+ * - nom_archive : Fichier archive.
+ * - repertoire : Reçoit le répertoire.
+ * Retourne : L'archive ouverte, ou NULL en cas d'erreur.
+ */
+static FILE* ouvrir_archive(const char* nom_archive, struct RepertoireArchive* repertoire) {
+    FILE* archive = fopen(nom_archive, "rb");
+    if (!archive) {
+        perror("Ne peut pas ouvrir l'archive");
+        return NULL;
+    }
+    if (lire_repertoire(archive, repertoire) != 0) {
+        fclose(archive);
+        return NULL;
+    }
+    return archive;
+}
+
+/**
+ * Fonction : lister_archive
+ * Description : Affiche le contenu d'une archive à partir du seul répertoire central.
+ * Paramètres :
+ * - nom_archive : Fichier archive.
+ * Retourne : 0 en cas de succès, -1 si l'archive est invalide.
+ */
+int lister_archive(const char* nom_archive) {
+    struct RepertoireArchive repertoire;
+    FILE* archive = ouvrir_archive(nom_archive, &repertoire);
+    if (!archive) {
+        return -1;
+    }
+
+    unsigned long long total_original = 0, total_compresse = 0;
+    printf("%12s %13s %-8s %s\n", "Taille", "Compressé", "Codec", "Nom"); // "é" compte pour deux octets
+    for (uint32_t i = 0; i < repertoire.nb_entrees; i++) {
+        struct EntreeArchive* entree = &repertoire.entrees[i];
+        printf("%12llu %12llu %-8s %s\n", (unsigned long long)entree->taille_originale,
+               (unsigned long long)entree->taille_compressee, noms_codecs[entree->codec], repertoire.noms[i]);
+        total_original += entree->taille_originale;
+        total_compresse += entree->taille_compressee;
+    }
+    printf("%12llu %12llu          %u fichiers\n", total_original, total_compresse, repertoire.nb_entrees);
+
+    liberer_repertoire(&repertoire);
+    fclose(archive);
+    return 0;
+}
+
+/**
+ * Fonction : creer_dossiers_parents
+ * Description : Crée les dossiers intermédiaires d'un chemin (comme mkdir -p).
+ * Paramètres :
+ * - chemin : Chemin du fichier à créer.
+ */
+static void creer_dossiers_parents(const char* chemin) {
+    char* copie = strdup(chemin);
+    if (!copie) {
+        return;
+    }
+    for (char* p = strchr(copie, '/'); p; p = strchr(p + 1, '/')) {
+        *p = '\0';
+        mkdir(copie, 0755);
+        *p = '/';
+    }
+    free(copie);
+}
+
+/**
+ * Fonction : extraire_entree
+ * Description : Extrait une entrée en se positionnant directement sur ses données.
+ * Paramètres :
+ * - archive : Archive ouverte.
+ * - entree : Entrée du répertoire central.
+ * - nom : Nom du fichier à créer.
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur ou de corruption.
+ */
+static int extraire_entree(FILE* archive, const struct EntreeArchive* entree, const char* nom) {
+    if (!nom_sur(nom)) {
+        fprintf(stderr, "Nom refusé : %s\n", nom);
+        return -1;
+    }
+    creer_dossiers_parents(nom);
+    FILE* sortie = fopen(nom, "wb");
+    if (!sortie) {
+        fprintf(stderr, "Ne peut pas créer %s : %s\n", nom, strerror(errno));
+        return -1;
+    }
+    fseek(archive, (long)entree->decalage, SEEK_SET);
+
+    int resultat;
+    unsigned long long taille = 0;
+    if (entree->codec == CODEC_HUFFMAN) {
+        resultat = decompressStream(archive, sortie, &taille, NULL, NULL);
+    } else if (entree->codec == CODEC_LZW) {
+        resultat = decompresser_flux_lzw(archive, sortie, NULL);
+        taille = (unsigned long long)ftell(sortie);
+    } else {
+        // Entrée stockée : copie avec contrôle du CRC
+        unsigned char tampon[65536];
+        uint32_t crc = CRC32C_INIT;
+        while (taille < entree->taille_compressee) {
+            size_t a_lire = entree->taille_compressee - taille < sizeof(tampon) ? (size_t)(entree->taille_compressee - taille) : sizeof(tampon);
+            if (fread(tampon, 1, a_lire, archive) != a_lire) {
+                break;
+            }
+            crc = crc32c_maj(crc, tampon, a_lire);
+            fwrite(tampon, 1, a_lire, sortie);
+            taille += a_lire;
+        }
+        resultat = (taille == entree->taille_compressee && crc == entree->crc) ? 0 : -1;
+    }
+    fclose(sortie);
+
+    if (resultat != 0 || taille != entree->taille_originale) {
+        fprintf(stderr, "Échec de l'extraction de %s\n", nom);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Fonction : extraire_archive
+ * Description : Extrait toutes les entrées, ou seulement celles dont le nom est donné,
+ *               dans le dossier courant.
+ * Paramètres :
+ * - nom_archive : Fichier archive.
+ * - noms : Noms des entrées à extraire.
+ * - nb_noms : Nombre de noms (0 pour tout extraire).
+ * Retourne : 0 en cas de succès, -1 si une entrée est absente ou n'a pas pu être extraite.
+ */
+int extraire_archive(const char* nom_archive, char** noms, int nb_noms) {
+    struct RepertoireArchive repertoire;
+    FILE* archive = ouvrir_archive(nom_archive, &repertoire);
+    if (!archive) {
+        return -1;
+    }
+
+    int erreurs = 0, extraits = 0;
+    if (nb_noms == 0) {
+        for (uint32_t i = 0; i < repertoire.nb_entrees; i++) {
+            erreurs += extraire_entree(archive, &repertoire.entrees[i], repertoire.noms[i]) != 0;
+            extraits++;
+        }
+    }
+    for (int n = 0; n < nb_noms; n++) {
+        const char* recherche = nom_dans_archive(noms[n]);
+        uint32_t i = 0;
+        while (i < repertoire.nb_entrees && strcmp(repertoire.noms[i], recherche) != 0) {
+            i++;
+        }
+        if (i == repertoire.nb_entrees) {
+            fprintf(stderr, "%s absent de l'archive\n", noms[n]);
+            erreurs++;
+            continue;
+        }
+        erreurs += extraire_entree(archive, &repertoire.entrees[i], repertoire.noms[i]) != 0;
+        extraits++;
+    }
+
+    printf("%d fichiers extraits, %d erreurs\n", extraits - erreurs, erreurs);
+    liberer_repertoire(&repertoire);
+    fclose(archive);
+    return erreurs ? -1 : 0;
+}
+
+/**
+ * Fonction : verifier_archive
+ * Description : Vérifie le répertoire central puis le CRC des données de chaque entrée,
+ *               sans rien décompresser ni écrire.
+ * Paramètres :
+ * - nom_archive : Fichier archive.
+ * Retourne : 0 si l'archive est intacte, -1 sinon.
+ */
+int verifier_archive(const char* nom_archive) {
+    struct RepertoireArchive repertoire;
+    FILE* archive = ouvrir_archive(nom_archive, &repertoire);
+    if (!archive) {
+        return -1;
+    }
+
+    unsigned char* tampon = malloc(1 << 20);
+    int erreurs = tampon ? 0 : 1;
+    for (uint32_t i = 0; tampon && i < repertoire.nb_entrees; i++) {
+        struct EntreeArchive* entree = &repertoire.entrees[i];
+        uint32_t crc = CRC32C_INIT;
+        uint64_t restant = entree->taille_compressee;
+        fseek(archive, (long)entree->decalage, SEEK_SET);
+        while (restant > 0) {
+            size_t a_lire = restant < (1 << 20) ? (size_t)restant : (1 << 20);
+            if (fread(tampon, 1, a_lire, archive) != a_lire) {
+                break;
+            }
+            crc = crc32c_maj(crc, tampon, a_lire);
+            restant -= a_lire;
+        }
+        if (restant > 0 || crc != entree->crc) {
+            fprintf(stderr, "Entrée corrompue : %s\n", repertoire.noms[i]);
+            erreurs++;
+        }
+    }
+    free(tampon);
+
+    if (erreurs == 0) {
+        printf("Archive intacte : %u fichiers vérifiés (%s)\n", repertoire.nb_entrees, crc32c_implementation());
+    }
+    liberer_repertoire(&repertoire);
+    fclose(archive);
+    return erreurs ? -1 : 0;
+}
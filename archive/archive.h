@@ -0,0 +1,59 @@
+/* archive.h - Archive multi-fichiers avec répertoire central (format HVA1) */
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Organisation d'une archive :
+ *   "HVA1" | données du fichier 1 | données du fichier 2 | ... | répertoire central | pied
+ * Les données de chaque fichier sont un flux complet du codec choisi (HUF3, LZW3) ou les
+ * octets bruts (stocké). Le répertoire central liste toutes les entrées (struct EntreeArchive
+ * suivie du nom) et le pied, de taille fixe à la fin du fichier, indique où il se trouve :
+ * lister ou extraire un fichier ne demande pas de parcourir toute l'archive.
+ */
+#define ARCHIVE_MAGIQUE "HVA1"
+
+/* Codecs possibles pour une entrée */
+#define CODEC_STOCKE 0  // Octets bruts, quand la compression ne fait rien gagner
+#define CODEC_HUFFMAN 1
+#define CODEC_LZW 2
+
+/* Entrée du répertoire central, suivie de longueur_nom octets (nom sans '\0') */
+struct EntreeArchive {
+    uint64_t decalage;          // Position des données dans l'archive
+    uint64_t taille_compressee; // Nombre d'octets des données dans l'archive
+    uint64_t taille_originale;  // Taille du fichier d'origine
+    uint32_t crc;               // CRC32C des données telles que stockées dans l'archive
+    uint16_t longueur_nom;
+    uint8_t codec;              // CODEC_STOCKE, CODEC_HUFFMAN ou CODEC_LZW
+    uint8_t reserve;
+};
+
+/* Pied de l'archive, toujours dans ses derniers octets */
+struct PiedArchive {
+    uint64_t decalage_repertoire;
+    uint64_t taille_repertoire;
+    uint32_t nb_entrees;
+    uint32_t crc_repertoire;    // CRC32C du répertoire central
+    char magique[4];            // ARCHIVE_MAGIQUE, répété pour repérer une archive tronquée
+    uint32_t reserve;
+};
+
+/* Répertoire central chargé en mémoire */
+struct RepertoireArchive {
+    uint32_t nb_entrees;
+    struct EntreeArchive* entrees;
+    char** noms;                // Noms terminés par '\0'
+};
+
+/* Prototypes de fonctions */
+int creer_archive(const char* nom_archive, char** fichiers, int nb_fichiers, int codec, int nb_threads);
+int lire_repertoire(FILE* archive, struct RepertoireArchive* repertoire);
+void liberer_repertoire(struct RepertoireArchive* repertoire);
+int lister_archive(const char* nom_archive);
+int extraire_archive(const char* nom_archive, char** noms, int nb_noms);
+int verifier_archive(const char* nom_archive);
+
+#endif
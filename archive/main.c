@@ -0,0 +1,112 @@
+/* main.c - Programme d'archivage multi-fichiers (Huffman ou LZW, compression parallèle) */
+#define _XOPEN_SOURCE 700 // Pour nftw
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h> // Pour benchmark du temps
+#include "archive.h"
+
+// Liste des fichiers trouvés en parcourant les dossiers
+static char** liste_fichiers = NULL;
+static int nb_liste = 0, capacite_liste = 0;
+
+// Archive à créer, si elle existe déjà : elle ne doit pas s'archiver elle-même
+static struct stat archive_existante;
+static int archive_existe = 0;
+
+void afficher_aide() {
+    puts("Utilisation : archiveur commande archive [options] [fichiers...]\n"
+         "  c archive.hva [-l] [-j N] fichiers|dossiers...  créer une archive\n"
+         "  l archive.hva                                   lister le contenu\n"
+         "  x archive.hva [noms...]                         extraire tout ou partie\n"
+         "  v archive.hva                                   vérifier sans extraire\n"
+         "Options de création :\n"
+         "  -l    compresser avec LZW (Huffman par défaut)\n"
+         "  -j N  nombre de threads de compression (par défaut : nombre de processeurs)");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Fonction : ajouter_fichier
+ * Description : Rappel de nftw, ajoute chaque fichier ordinaire rencontré à la liste, sauf l'archive
+ *               en cours de création (reconnue à son périphérique et à son numéro d'inode).
+ */
+static int ajouter_fichier(const char* chemin, const struct stat* st, int type, struct FTW* ftw) {
+    (void)ftw;
+    if (type != FTW_F) {
+        return 0;
+    }
+    if (archive_existe && st->st_dev == archive_existante.st_dev && st->st_ino == archive_existante.st_ino) {
+        fprintf(stderr, "%s ignoré : c'est l'archive en cours de création\n", chemin);
+        return 0;
+    }
+    if (nb_liste == capacite_liste) {
+        capacite_liste = capacite_liste ? capacite_liste * 2 : 64;
+        char** nouvelle = realloc(liste_fichiers, capacite_liste * sizeof(char*));
+        if (!nouvelle) {
+            return -1;
+        }
+        liste_fichiers = nouvelle;
+    }
+    liste_fichiers[nb_liste] = strdup(chemin);
+    return liste_fichiers[nb_liste++] ? 0 : -1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        afficher_aide();
+    }
+    char commande = argv[1][0];
+    const char* nom_archive = argv[2];
+    int resultat;
+
+    // Temps réel : clock() additionnerait le temps de tous les threads
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (commande == 'c') {
+        int codec = CODEC_HUFFMAN;
+        int nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        int i = 3;
+        for (; i < argc && argv[i][0] == '-'; i++) {
+            if (strcmp(argv[i], "-l") == 0) {
+                codec = CODEC_LZW;
+            } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                nb_threads = atoi(argv[++i]);
+            } else {
+                afficher_aide();
+            }
+        }
+        // Les dossiers sont parcourus récursivement
+        archive_existe = stat(nom_archive, &archive_existante) == 0;
+        for (; i < argc; i++) {
+            if (nftw(argv[i], ajouter_fichier, 16, FTW_PHYS) != 0) {
+                fprintf(stderr, "Ne peut pas parcourir %s\n", argv[i]);
+            }
+        }
+        if (nb_liste == 0) {
+            afficher_aide();
+        }
+        resultat = creer_archive(nom_archive, liste_fichiers, nb_liste, codec, nb_threads);
+        for (int f = 0; f < nb_liste; f++) {
+            free(liste_fichiers[f]);
+        }
+        free(liste_fichiers);
+    } else if (commande == 'l') {
+        resultat = lister_archive(nom_archive);
+    } else if (commande == 'x') {
+        resultat = extraire_archive(nom_archive, argv + 3, argc - 3);
+    } else if (commande == 'v') {
+        resultat = verifier_archive(nom_archive);
+    } else {
+        afficher_aide();
+        return EXIT_FAILURE;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double timeTaken = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Temps d'exécution : %.2f secondes\n", timeTaken);
+    return resultat == 0 ? 0 : EXIT_FAILURE;
+}
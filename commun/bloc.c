@@ -0,0 +1,135 @@
+/* bloc.c - Lecture et vérification des blocs compressés, communes à Huffman et LZW */
+#include "bloc.h"
+#include "crc32c.h"
+#include "memoire.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h> // Pour le débit de la vérification
+
+
+/**
+ * Fonction : calculer_crc_bloc
+ * Description : Calcule le CRC32C qui protège un bloc sur le disque : les champs de taille
+ *               et de CRC des données de l'en-tête, puis les octets compressés.
+ * Paramètres :
+ * - en_tete : En-tête du bloc (le champ crc_bloc est ignoré).
+ * - corps : Les taille_compressee octets qui suivent l'en-tête.
+ * Retourne : Le CRC à stocker dans (ou comparer à) en_tete->crc_bloc.
+ */
+uint32_t calculer_crc_bloc(const struct EnTeteBloc* en_tete, const unsigned char* corps) {
+    uint32_t crc = crc32c_maj(CRC32C_INIT, en_tete, TAILLE_EN_TETE_CRC);
+    return crc32c_maj(crc, corps, en_tete->taille_compressee);
+}
+
+/**
+ * Fonction : lire_bloc
+ * Description : Lit l'en-tête et le corps du prochain bloc, puis vérifie son CRC de bloc.
+ *               Le tampon du corps est réutilisé d'un appel à l'autre et agrandi au besoin.
+ *               Les tailles annoncées sont bornées avant toute allocation : un en-tête forgé
+ *               ne peut pas provoquer d'allocation démesurée.
+ * Paramètres :
+ * - fichier : Fichier positionné au début d'un en-tête de bloc.
+ * - en_tete : Reçoit l'en-tête lu.
+ * - corps : Pointeur vers le tampon du corps (peut pointer vers NULL au premier appel),
+ *           à libérer avec memoire_liberer.
+ * - capacite : Taille actuelle du tampon du corps.
+ * - taille_originale_max : Taille maximale d'un bloc décompressé pour ce codec.
+ * - taille_compressee_max : Taille maximale du corps d'un bloc pour ce codec.
+ * Retourne : 1 si un bloc valide a été lu, 0 à la fin du flux, -1 en cas d'erreur ou de corruption.
+ */
+int lire_bloc(FILE* fichier, struct EnTeteBloc* en_tete, unsigned char** corps, size_t* capacite,
+              uint32_t taille_originale_max, uint32_t taille_compressee_max) {
+    if (fread(en_tete, sizeof(struct EnTeteBloc), 1, fichier) != 1) {
+        fprintf(stderr, "Flux tronqué : marqueur de fin absent\n");
+        return -1;
+    }
+    if (en_tete->taille_originale == 0) {
+        return 0; // Marqueur de fin
+    }
+    if (en_tete->taille_originale > taille_originale_max || en_tete->taille_compressee == 0 ||
+        en_tete->taille_compressee > taille_compressee_max) {
+        fprintf(stderr, "Bloc invalide : tailles hors limites (%u / %u octets)\n",
+                en_tete->taille_originale, en_tete->taille_compressee);
+        return -1;
+    }
+
+    if (en_tete->taille_compressee > *capacite) {
+        unsigned char* nouveau = memoire_reallouer(*corps, en_tete->taille_compressee);
+        if (!nouveau) {
+            fprintf(stderr, "Mémoire insuffisante pour un bloc de %u octets\n", en_tete->taille_compressee);
+            return -1;
+        }
+        *corps = nouveau;
+        *capacite = en_tete->taille_compressee;
+    }
+    if (fread(*corps, 1, en_tete->taille_compressee, fichier) != en_tete->taille_compressee) {
+        fprintf(stderr, "Flux tronqué : bloc incomplet\n");
+        return -1;
+    }
+
+    if (calculer_crc_bloc(en_tete, *corps) != en_tete->crc_bloc) {
+        fprintf(stderr, "Bloc corrompu : CRC32C incorrect\n");
+        return -1;
+    }
+    return 1;
+}
+
+/**
+ * Fonction : verifier_fichier_blocs
+ * Description : Vérifie l'intégrité d'un fichier compressé sans le décompresser ni rien écrire.
+ *               Seuls les CRC de bloc sont contrôlés, ce qui se fait à la vitesse de lecture
+ *               mémoire ; le CRC des données originales n'est contrôlé qu'à la décompression.
+ * Paramètres :
+ * - nom_fichier : Nom du fichier compressé.
+ * - magique : Nombre magique attendu (TAILLE_MAGIQUE octets).
+ * - taille_originale_max, taille_compressee_max : Limites du codec, voir lire_bloc.
+ * Retourne : 0 si tous les blocs sont intacts, -1 sinon.
+ */
+int verifier_fichier_blocs(const char* nom_fichier, const char* magique,
+                           uint32_t taille_originale_max, uint32_t taille_compressee_max) {
+    FILE* fichier = fopen(nom_fichier, "rb");
+    if (!fichier) {
+        perror("Ne peut pas ouvrir le fichier");
+        return -1;
+    }
+
+    char magique_lu[TAILLE_MAGIQUE];
+    if (fread(magique_lu, 1, TAILLE_MAGIQUE, fichier) != TAILLE_MAGIQUE ||
+        memcmp(magique_lu, magique, TAILLE_MAGIQUE) != 0) {
+        fprintf(stderr, "%s n'est pas un fichier %.4s\n", nom_fichier, magique);
+        fclose(fichier);
+        return -1;
+    }
+
+    struct EnTeteBloc en_tete;
+    unsigned char* corps = NULL;
+    size_t capacite = 0;
+    unsigned long nb_blocs = 0;
+    unsigned long long total_compresse = 0, total_original = 0;
+    int resultat;
+
+    clock_t debut = clock();
+    while ((resultat = lire_bloc(fichier, &en_tete, &corps, &capacite,
+                                  taille_originale_max, taille_compressee_max)) == 1) {
+        nb_blocs++;
+        total_compresse += en_tete.taille_compressee;
+        total_original += en_tete.taille_originale;
+    }
+    double duree = (double)(clock() - debut) / CLOCKS_PER_SEC;
+
+    memoire_liberer(corps);
+    fclose(fichier);
+
+    if (resultat < 0) {
+        fprintf(stderr, "Vérification échouée au bloc %lu\n", nb_blocs + 1);
+        return -1;
+    }
+
+    printf("Vérification réussie (%s) :\n", crc32c_implementation());
+    printf(" - Blocs vérifiés : %lu\n", nb_blocs);
+    printf(" - Octets compressés : %llu (%llu octets originaux)\n", total_compresse, total_original);
+    if (duree > 0) {
+        printf(" - Débit : %.1f Mo/s\n", total_compresse / duree / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+/* bloc.h - En-tête commun des blocs compressés (formats HUF2, HUF3, LZW2 et LZW3) */
+#ifndef BLOC_H
+#define BLOC_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Chaque fichier compressé commence par un nombre magique de 4 octets propre au codec,
+ * suivi d'une suite de blocs indépendants. Un en-tête dont taille_originale vaut 0 marque la fin. */
+#define TAILLE_MAGIQUE 4
+
+struct EnTeteBloc {
+    uint32_t taille_originale;  // Nombre d'octets du bloc avant compression
+    uint32_t taille_compressee; // Nombre d'octets qui suivent l'en-tête
+    uint32_t crc_donnees;       // CRC32C des octets originaux (vérifié à la décompression)
+    uint32_t crc_bloc;          // CRC32C des 3 champs précédents et des octets compressés (vérification rapide)
+};
+
+/* Nombre d'octets de l'en-tête couverts par crc_bloc */
+#define TAILLE_EN_TETE_CRC (3 * sizeof(uint32_t))
+
+/* Prototypes de fonctions */
+uint32_t calculer_crc_bloc(const struct EnTeteBloc* en_tete, const unsigned char* corps);
+int lire_bloc(FILE* fichier, struct EnTeteBloc* en_tete, unsigned char** corps, size_t* capacite,
+              uint32_t taille_originale_max, uint32_t taille_compressee_max);
+int verifier_fichier_blocs(const char* nom_fichier, const char* magique,
+                           uint32_t taille_originale_max, uint32_t taille_compressee_max);
+
+#endif
@@ -0,0 +1,140 @@
+/* crc32c.c - CRC32C accéléré par l'instruction SSE4.2 crc32 lorsqu'elle est disponible,
+ * avec une version logicielle (slicing-by-8) comme repli sur les autres processeurs. */
+#include "crc32c.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define CRC32C_X86 1
+#endif
+
+#define CRC32C_POLY 0x82F63B78u // Polynôme de Castagnoli (forme réfléchie)
+
+// Tables pour la version logicielle, remplies au chargement du programme
+static uint32_t table_crc[8][256];
+
+// Implémentation choisie au chargement du programme (matérielle ou logicielle)
+static uint32_t (*crc32c_fonction)(uint32_t, const unsigned char*, size_t) = NULL;
+
+
+/**
+ * Fonction : initialiser_tables
+ * Description : Construit les 8 tables nécessaires à l'algorithme slicing-by-8.
+ *               La table 0 est la table classique octet par octet, les suivantes
+ *               permettent de traiter 8 octets par itération.
+ */
+static void initialiser_tables(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        table_crc[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            table_crc[t][i] = (table_crc[t - 1][i] >> 8) ^ table_crc[0][table_crc[t - 1][i] & 0xFF];
+        }
+    }
+}
+
+/**
+ * Fonction : crc32c_logiciel
+ * Description : Calcule le CRC32C sans instruction dédiée, 8 octets à la fois.
+ * Paramètres :
+ * - crc : CRC déjà inversé (état interne).
+ * - p : Données à intégrer.
+ * - n : Nombre d'octets.
+ * Retourne : Le nouvel état interne.
+ */
+static uint32_t crc32c_logiciel(uint32_t crc, const unsigned char* p, size_t n) {
+    while (n >= 8) {
+        uint32_t bas, haut;
+        memcpy(&bas, p, 4);
+        memcpy(&haut, p + 4, 4);
+        bas ^= crc;
+        crc = table_crc[7][bas & 0xFF] ^ table_crc[6][(bas >> 8) & 0xFF] ^
+              table_crc[5][(bas >> 16) & 0xFF] ^ table_crc[4][bas >> 24] ^
+              table_crc[3][haut & 0xFF] ^ table_crc[2][(haut >> 8) & 0xFF] ^
+              table_crc[1][(haut >> 16) & 0xFF] ^ table_crc[0][haut >> 24];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) {
+        crc = (crc >> 8) ^ table_crc[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRC32C_X86
+/**
+ * Fonction : crc32c_sse42
+ * Description : Calcule le CRC32C avec l'instruction crc32 de SSE4.2 (8 octets par instruction).
+ *               Compilée pour SSE4.2 uniquement, elle n'est appelée que si le processeur la supporte.
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char* p, size_t n) {
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    while (n >= 8) {
+        uint64_t mot;
+        memcpy(&mot, p, 8);
+        crc64 = _mm_crc32_u64(crc64, mot);
+        p += 8;
+        n -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+    while (n--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+/**
+ * Fonction : choisir_implementation
+ * Description : Détecte si le processeur dispose de SSE4.2. Exécutée au chargement du
+ *               programme, avant tout thread : les codecs peuvent ensuite calculer des CRC
+ *               depuis plusieurs threads sans synchronisation.
+ */
+__attribute__((constructor))
+static void choisir_implementation(void) {
+#ifdef CRC32C_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32c_fonction = crc32c_sse42;
+        return;
+    }
+#endif
+    initialiser_tables();
+    crc32c_fonction = crc32c_logiciel;
+}
+
+/**
+ * Fonction : crc32c_maj
+ * Description : Met à jour un CRC32C avec de nouvelles données. Les appels successifs
+ *               sur des tranches consécutives donnent le même résultat qu'un seul appel.
+ * Paramètres :
+ * - crc : CRC précédent (CRC32C_INIT pour commencer).
+ * - donnees : Données à intégrer.
+ * - taille : Nombre d'octets.
+ * Retourne : Le CRC mis à jour.
+ */
+uint32_t crc32c_maj(uint32_t crc, const void* donnees, size_t taille) {
+    return ~crc32c_fonction(~crc, (const unsigned char*)donnees, taille);
+}
+
+/**
+ * Fonction : crc32c_implementation
+ * Description : Indique l'implémentation utilisée, pour l'affichage des résumés.
+ * Retourne : "sse4.2" ou "logiciel".
+ */
+const char* crc32c_implementation(void) {
+#ifdef CRC32C_X86
+    if (crc32c_fonction == crc32c_sse42) {
+        return "sse4.2";
+    }
+#endif
+    return "logiciel";
+}
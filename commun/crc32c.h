@@ -0,0 +1,19 @@
+/* crc32c.h - Somme de contrôle CRC32C (polynôme de Castagnoli) partagée par les deux codecs */
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Taille des tranches sur lesquelles les codecs calculent le CRC pendant l'encodage/décodage.
+ * 4 Ko tiennent largement dans le cache L1 : la tranche est encore chaude quand on la somme. */
+#define CRC32C_TRANCHE 4096
+
+/* Valeur initiale à passer à crc32c_maj pour un nouveau calcul */
+#define CRC32C_INIT 0u
+
+/* Prototypes de fonctions */
+uint32_t crc32c_maj(uint32_t crc, const void* donnees, size_t taille);
+const char* crc32c_implementation(void);
+
+#endif
@@ -0,0 +1,232 @@
+/* es_async.c - Lectures et écritures asynchrones : io_uring, ou pread/pwrite à défaut */
+#include "es_async.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define AVEC_IO_URING 1
+#endif
+#endif
+
+#ifdef AVEC_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* Pas de liburing : les deux appels système sont utilisés directement */
+static int io_uring_setup(unsigned entrees, struct io_uring_params* parametres) {
+    return (int)syscall(__NR_io_uring_setup, entrees, parametres);
+}
+
+static int io_uring_enter(int anneau, unsigned a_soumettre, unsigned a_attendre, unsigned drapeaux) {
+    return (int)syscall(__NR_io_uring_enter, anneau, a_soumettre, a_attendre, drapeaux, NULL, 0);
+}
+
+/**
+ * Fonction : ouvrir_io_uring
+ * Description : Crée l'anneau io_uring et projette en mémoire ses files de soumission et de complétion.
+ * Paramètres :
+ * - file : File à préparer (profondeur déjà fixée).
+ * Retourne : 0 en cas de succès, -1 si io_uring est indisponible (noyau ancien, interdit, etc.).
+ */
+static int ouvrir_io_uring(struct FileES* file) {
+    struct io_uring_params parametres;
+    memset(&parametres, 0, sizeof(parametres));
+    int anneau = io_uring_setup(file->profondeur, &parametres);
+    if (anneau < 0) {
+        return -1;
+    }
+
+    file->sq_taille = parametres.sq_off.array + parametres.sq_entries * sizeof(unsigned);
+    file->cq_taille = parametres.cq_off.cqes + parametres.cq_entries * sizeof(struct io_uring_cqe);
+    int projection_unique = (parametres.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (projection_unique && file->cq_taille > file->sq_taille) {
+        file->sq_taille = file->cq_taille;
+    }
+
+    file->sq_zone = mmap(NULL, file->sq_taille, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         anneau, IORING_OFF_SQ_RING);
+    if (file->sq_zone == MAP_FAILED) {
+        close(anneau);
+        return -1;
+    }
+    if (projection_unique) {
+        file->cq_zone = file->sq_zone;
+    } else {
+        file->cq_zone = mmap(NULL, file->cq_taille, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             anneau, IORING_OFF_CQ_RING);
+        if (file->cq_zone == MAP_FAILED) {
+            munmap(file->sq_zone, file->sq_taille);
+            close(anneau);
+            return -1;
+        }
+    }
+    file->sqes_taille = parametres.sq_entries * sizeof(struct io_uring_sqe);
+    file->sqes = mmap(NULL, file->sqes_taille, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      anneau, IORING_OFF_SQES);
+    if (file->sqes == MAP_FAILED) {
+        if (!projection_unique) {
+            munmap(file->cq_zone, file->cq_taille);
+        }
+        munmap(file->sq_zone, file->sq_taille);
+        close(anneau);
+        return -1;
+    }
+
+    char* sq = file->sq_zone;
+    char* cq = file->cq_zone;
+    file->sq_tete = (unsigned*)(sq + parametres.sq_off.head);
+    file->sq_queue = (unsigned*)(sq + parametres.sq_off.tail);
+    file->sq_masque = (unsigned*)(sq + parametres.sq_off.ring_mask);
+    file->sq_tableau = (unsigned*)(sq + parametres.sq_off.array);
+    file->cq_tete = (unsigned*)(cq + parametres.cq_off.head);
+    file->cq_queue = (unsigned*)(cq + parametres.cq_off.tail);
+    file->cq_masque = (unsigned*)(cq + parametres.cq_off.ring_mask);
+    file->cqes = cq + parametres.cq_off.cqes;
+    file->anneau = anneau;
+    return 0;
+}
+#endif
+
+/**
+ * Fonction : es_initialiser
+ * Description : Prépare une file d'entrées/sorties. io_uring est utilisé s'il est disponible,
+ *               sinon la file fonctionne en mode bloquant avec la même interface.
+ * Paramètres :
+ * - file : File à préparer.
+ * - profondeur : Opérations en vol au plus (bornée à ES_PROFONDEUR_MAX).
+ * - bloquante : 1 pour forcer le mode bloquant.
+ */
+void es_initialiser(struct FileES* file, unsigned profondeur, int bloquante) {
+    memset(file, 0, sizeof(*file));
+    file->anneau = -1;
+    file->profondeur = profondeur == 0 ? 1 : profondeur > ES_PROFONDEUR_MAX ? ES_PROFONDEUR_MAX : profondeur;
+#ifdef AVEC_IO_URING
+    if (!bloquante) {
+        ouvrir_io_uring(file);
+    }
+#else
+    (void)bloquante;
+#endif
+}
+
+/**
+ * Fonction : es_soumettre
+ * Description : Soumet une lecture ou une écriture de taille octets à la position decalage.
+ *               En mode bloquant, l'opération est faite immédiatement (sans réessai si elle est
+ *               partielle : c'est à l'appelant de le traiter).
+ * Paramètres :
+ * - file : File utilisée.
+ * - ecriture : 1 pour une écriture, 0 pour une lecture.
+ * - fd, tampon, taille, decalage : Description de l'opération.
+ * - etiquette : Valeur rendue avec la complétion.
+ * Retourne : 0 en cas de succès, -1 si la file est pleine ou si la soumission échoue.
+ */
+int es_soumettre(struct FileES* file, int ecriture, int fd, void* tampon, size_t taille,
+                 uint64_t decalage, uint64_t etiquette) {
+    if (file->en_vol >= file->profondeur) {
+        return -1;
+    }
+#ifdef AVEC_IO_URING
+    if (file->anneau >= 0) {
+        unsigned queue = *file->sq_queue;
+        unsigned index = queue & *file->sq_masque;
+        struct io_uring_sqe* sqe = (struct io_uring_sqe*)file->sqes + index;
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = ecriture ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t)(uintptr_t)tampon;
+        sqe->len = (uint32_t)taille;
+        sqe->off = decalage;
+        sqe->user_data = etiquette;
+        file->sq_tableau[index] = index;
+        __atomic_store_n(file->sq_queue, queue + 1, __ATOMIC_RELEASE);
+
+        int soumis;
+        do {
+            soumis = io_uring_enter(file->anneau, 1, 0, 0);
+        } while (soumis < 0 && errno == EINTR);
+        if (soumis < 0) {
+            return -1;
+        }
+        file->en_vol++;
+        return 0;
+    }
+#endif
+    ssize_t resultat;
+    do {
+        resultat = ecriture ? pwrite(fd, tampon, taille, (off_t)decalage) : pread(fd, tampon, taille, (off_t)decalage);
+    } while (resultat < 0 && errno == EINTR);
+    struct CompletionES* completion = &file->prets[(file->premier_pret + file->en_vol) % ES_PROFONDEUR_MAX];
+    completion->etiquette = etiquette;
+    completion->resultat = resultat < 0 ? -errno : (long)resultat;
+    file->en_vol++;
+    return 0;
+}
+
+/**
+ * Fonction : es_attendre
+ * Description : Attend la complétion d'une opération soumise (dans un ordre quelconque avec io_uring).
+ * Paramètres :
+ * - file : File utilisée.
+ * - completion : Reçoit l'étiquette et le résultat de l'opération.
+ * Retourne : 0 en cas de succès, -1 si aucune opération n'est en vol ou en cas d'erreur.
+ */
+int es_attendre(struct FileES* file, struct CompletionES* completion) {
+    if (file->en_vol == 0) {
+        return -1;
+    }
+#ifdef AVEC_IO_URING
+    if (file->anneau >= 0) {
+        for (;;) {
+            unsigned tete = *file->cq_tete;
+            if (tete != __atomic_load_n(file->cq_queue, __ATOMIC_ACQUIRE)) {
+                struct io_uring_cqe* cqe = (struct io_uring_cqe*)file->cqes + (tete & *file->cq_masque);
+                completion->etiquette = cqe->user_data;
+                completion->resultat = cqe->res;
+                __atomic_store_n(file->cq_tete, tete + 1, __ATOMIC_RELEASE);
+                file->en_vol--;
+                return 0;
+            }
+            if (io_uring_enter(file->anneau, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                return -1;
+            }
+        }
+    }
+#endif
+    *completion = file->prets[file->premier_pret];
+    file->premier_pret = (file->premier_pret + 1) % ES_PROFONDEUR_MAX;
+    file->en_vol--;
+    return 0;
+}
+
+/**
+ * Fonction : es_liberer
+ * Description : Libère la file. Les opérations encore en vol doivent avoir été attendues.
+ * Paramètres :
+ * - file : File à libérer.
+ */
+void es_liberer(struct FileES* file) {
+#ifdef AVEC_IO_URING
+    if (file->anneau >= 0) {
+        munmap(file->sqes, file->sqes_taille);
+        if (file->cq_zone != file->sq_zone) {
+            munmap(file->cq_zone, file->cq_taille);
+        }
+        munmap(file->sq_zone, file->sq_taille);
+        close(file->anneau);
+        file->anneau = -1;
+    }
+#endif
+}
+
+/**
+ * Fonction : es_methode
+ * Description : Indique la méthode utilisée par la file, pour les résumés.
+ * Retourne : "io_uring" ou "bloquante".
+ */
+const char* es_methode(const struct FileES* file) {
+    return file->anneau >= 0 ? "io_uring" : "bloquante";
+}
@@ -0,0 +1,47 @@
+/* es_async.h - Lectures et écritures asynchrones à des positions données : io_uring quand le
+ * noyau le permet, pread/pwrite bloquants sinon. Une file n'est utilisée que par un seul thread. */
+#ifndef ES_ASYNC_H
+#define ES_ASYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ES_PROFONDEUR_MAX 64 // Opérations en vol au plus dans une file
+
+/* Résultat d'une opération : l'étiquette donnée à la soumission, et le nombre d'octets
+ * transférés ou -errno */
+struct CompletionES {
+    uint64_t etiquette;
+    long resultat;
+};
+
+struct FileES {
+    int anneau;             // Descripteur io_uring, -1 en mode bloquant
+    unsigned profondeur;    // Opérations en vol au plus
+    unsigned en_vol;        // Opérations soumises dont la complétion n'a pas encore été lue
+
+    /* io_uring : anneaux partagés avec le noyau */
+    void* sq_zone;
+    size_t sq_taille;
+    void* cq_zone;
+    size_t cq_taille;
+    void* sqes;
+    size_t sqes_taille;
+    unsigned *sq_tete, *sq_queue, *sq_masque, *sq_tableau;
+    unsigned *cq_tete, *cq_queue, *cq_masque;
+    void* cqes;
+
+    /* Mode bloquant : les opérations sont faites à la soumission, leurs complétions attendent ici */
+    struct CompletionES prets[ES_PROFONDEUR_MAX];
+    unsigned premier_pret;
+};
+
+/* Prototypes de fonctions */
+void es_initialiser(struct FileES* file, unsigned profondeur, int bloquante);
+int es_soumettre(struct FileES* file, int ecriture, int fd, void* tampon, size_t taille,
+                 uint64_t decalage, uint64_t etiquette);
+int es_attendre(struct FileES* file, struct CompletionES* completion);
+void es_liberer(struct FileES* file);
+const char* es_methode(const struct FileES* file);
+
+#endif
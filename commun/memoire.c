@@ -0,0 +1,119 @@
+/* memoire.c - Allocations comptées, pour mesurer la mémoire de travail de chaque appel */
+#include "memoire.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Placé devant chaque allocation ; la taille de l'union garde l'alignement de malloc */
+union EnTeteMemoire {
+    struct {
+        size_t taille;                      // Octets alloués, en-tête compris
+        struct CompteurMemoire* compteur;   // Compteur à décompter à la libération (peut être NULL)
+    } champs;
+    max_align_t alignement;
+};
+
+_Static_assert(sizeof(union EnTeteMemoire) == MEMOIRE_SURCOUT, "MEMOIRE_SURCOUT doit couvrir l'en-tête");
+
+// Compteur des allocations faites par le thread courant (NULL : allocations non comptées)
+static _Thread_local struct CompteurMemoire* compteur_actif = NULL;
+
+void compteur_memoire_initialiser(struct CompteurMemoire* compteur) {
+    atomic_init(&compteur->courant, 0);
+    atomic_init(&compteur->pic, 0);
+}
+
+/**
+ * Fonction : compteur_memoire_attacher
+ * Description : Fait compter les allocations du thread courant dans compteur.
+ * Paramètres :
+ * - compteur : Compteur à utiliser, NULL pour ne plus compter.
+ * Retourne : Le compteur attaché jusque-là, à rattacher une fois la mesure finie.
+ */
+struct CompteurMemoire* compteur_memoire_attacher(struct CompteurMemoire* compteur) {
+    struct CompteurMemoire* precedent = compteur_actif;
+    compteur_actif = compteur;
+    return precedent;
+}
+
+static void compter(struct CompteurMemoire* compteur, size_t taille) {
+    if (!compteur) {
+        return;
+    }
+    size_t courant = atomic_fetch_add(&compteur->courant, taille) + taille;
+    size_t pic = atomic_load(&compteur->pic);
+    while (courant > pic && !atomic_compare_exchange_weak(&compteur->pic, &pic, courant)) {
+        // pic a été relu par l'échec de l'échange : on recommence avec sa valeur actuelle
+    }
+}
+
+/**
+ * Fonction : memoire_allouer
+ * Description : Comme malloc, en comptant l'allocation dans le compteur du thread courant.
+ * Retourne : La zone allouée, à libérer avec memoire_liberer, ou NULL.
+ */
+void* memoire_allouer(size_t taille) {
+    if (taille > SIZE_MAX - MEMOIRE_SURCOUT) {
+        return NULL;
+    }
+    union EnTeteMemoire* en_tete = malloc(MEMOIRE_SURCOUT + taille);
+    if (!en_tete) {
+        return NULL;
+    }
+    en_tete->champs.taille = MEMOIRE_SURCOUT + taille;
+    en_tete->champs.compteur = compteur_actif;
+    compter(compteur_actif, en_tete->champs.taille);
+    return en_tete + 1;
+}
+
+// Comme calloc, voir memoire_allouer
+void* memoire_allouer_zero(size_t nombre, size_t taille) {
+    if (taille != 0 && nombre > SIZE_MAX / taille) {
+        return NULL;
+    }
+    void* zone = memoire_allouer(nombre * taille);
+    if (zone) {
+        memset(zone, 0, nombre * taille);
+    }
+    return zone;
+}
+
+/**
+ * Fonction : memoire_reallouer
+ * Description : Comme realloc. La zone reste comptée dans le compteur de sa première allocation.
+ * Retourne : La nouvelle zone, ou NULL (l'ancienne reste alors valide).
+ */
+void* memoire_reallouer(void* ancien, size_t taille) {
+    if (!ancien) {
+        return memoire_allouer(taille);
+    }
+    if (taille > SIZE_MAX - MEMOIRE_SURCOUT) {
+        return NULL;
+    }
+    union EnTeteMemoire* en_tete = (union EnTeteMemoire*)ancien - 1;
+    struct CompteurMemoire* compteur = en_tete->champs.compteur;
+    size_t ancienne_taille = en_tete->champs.taille;
+    union EnTeteMemoire* nouveau = realloc(en_tete, MEMOIRE_SURCOUT + taille);
+    if (!nouveau) {
+        return NULL;
+    }
+    nouveau->champs.taille = MEMOIRE_SURCOUT + taille;
+    if (compteur) {
+        // Compté avant le décompte : le pic couvre le moment où les deux zones coexistent
+        compter(compteur, nouveau->champs.taille);
+        atomic_fetch_sub(&compteur->courant, ancienne_taille);
+    }
+    return nouveau + 1;
+}
+
+// Libère une zone de memoire_allouer et la décompte de son compteur (NULL est accepté)
+void memoire_liberer(void* pointeur) {
+    if (!pointeur) {
+        return;
+    }
+    union EnTeteMemoire* en_tete = (union EnTeteMemoire*)pointeur - 1;
+    if (en_tete->champs.compteur) {
+        atomic_fetch_sub(&en_tete->champs.compteur->courant, en_tete->champs.taille);
+    }
+    free(en_tete);
+}
@@ -0,0 +1,28 @@
+/* memoire.h - Mesure de la mémoire de travail. Les codecs et le pipeline allouent par
+ * memoire_allouer et libèrent par memoire_liberer : chaque allocation est comptée dans le
+ * compteur attaché au thread qui la fait, et décomptée du même compteur quel que soit le thread
+ * qui la libère. Le pipeline attache un compteur à tous ses threads, ce qui donne le pic de
+ * mémoire de chaque appel, même quand plusieurs appels tournent en parallèle. */
+#ifndef MEMOIRE_H
+#define MEMOIRE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* Octets ajoutés devant chaque allocation pour retrouver sa taille et son compteur */
+#define MEMOIRE_SURCOUT sizeof(max_align_t)
+
+struct CompteurMemoire {
+    atomic_size_t courant;  // Octets alloués et pas encore libérés (surcoût compris)
+    atomic_size_t pic;      // Plus grande valeur atteinte par courant
+};
+
+/* Prototypes de fonctions */
+void compteur_memoire_initialiser(struct CompteurMemoire* compteur);
+struct CompteurMemoire* compteur_memoire_attacher(struct CompteurMemoire* compteur);
+void* memoire_allouer(size_t taille);
+void* memoire_allouer_zero(size_t nombre, size_t taille);
+void* memoire_reallouer(void* ancien, size_t taille);
+void memoire_liberer(void* pointeur);
+
+#endif
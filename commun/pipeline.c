@@ -0,0 +1,708 @@
+/* pipeline.c - Lecture, calcul et écriture en parallèle, par blocs */
+#include "pipeline.h"
+#include "bloc.h"
+#include "es_async.h"
+#include "memoire.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ES_LECTURES_EN_VOL 4 // Lectures anticipées en DECOUPAGE_TRANCHES
+#define ES_ECRITURES_EN_VOL 4
+
+/* Un bloc en cours de traitement, de sa lecture à la fin de son écriture */
+struct Tache {
+    uint64_t index;           // Rang du bloc dans l'entrée, donc dans la sortie
+    unsigned char* entree;
+    size_t taille_entree;
+    unsigned char* sortie;
+    size_t taille_sortie;
+    uint64_t decalage;        // Position de la sortie dans le fichier de sortie
+    size_t ecrit;             // Octets déjà écrits (écritures partielles)
+};
+
+struct Pipeline {
+    const struct ParametresPipeline* parametres;
+    int fd_entree, fd_sortie;
+    uint64_t decalage_entree, decalage_sortie;
+    int entree_sequentielle;        // Entrée sans positions (tube, terminal) : lue dans l'ordre par read
+    int profondeur;
+    struct CompteurMemoire* compteur; // Attaché à chaque thread du pipeline
+
+    pthread_mutex_t verrou;         // Protège tous les champs qui suivent
+    pthread_cond_t cond_jetons;     // Une place s'est libérée (attendue par la lecture)
+    pthread_cond_t cond_calcul;     // Un bloc est à calculer (attendu par les travailleurs)
+    pthread_cond_t cond_ecriture;   // Un bloc est calculé (attendu par l'écriture)
+    int jetons;                     // Places libres : blocs qui peuvent encore entrer dans le pipeline
+    struct Tache** a_calculer;      // Anneau FIFO lecture -> travailleurs
+    int debut_a_calculer, nb_a_calculer;
+    struct Tache** calculees;       // Anneau travailleurs -> écriture, case index % profondeur
+    uint64_t nb_total;              // Nombre de blocs, connu quand lecture_finie vaut 1
+    int lecture_finie;
+    int erreur;
+
+    /* Mesures */
+    double attente_lecture, temps_calcul, attente_ecriture;
+    double duree_lecture;           // Du lancement du thread de lecture à la fin de l'entrée
+    unsigned long long octets_lus, octets_ecrits;
+    const char* methode_es;
+};
+
+static double maintenant(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void signaler_erreur(struct Pipeline* p) {
+    pthread_mutex_lock(&p->verrou);
+    p->erreur = 1;
+    pthread_cond_broadcast(&p->cond_jetons);
+    pthread_cond_broadcast(&p->cond_calcul);
+    pthread_cond_broadcast(&p->cond_ecriture);
+    pthread_mutex_unlock(&p->verrou);
+}
+
+/**
+ * Fonction : prendre_jeton
+ * Description : Réserve une place dans le pipeline pour un nouveau bloc.
+ * Paramètres :
+ * - p : Pipeline.
+ * - attendre : 1 pour attendre qu'une place se libère, 0 pour renoncer tout de suite.
+ * Retourne : 1 si une place est réservée, 0 si aucune n'est libre, -1 si le pipeline est en erreur.
+ */
+static int prendre_jeton(struct Pipeline* p, int attendre) {
+    pthread_mutex_lock(&p->verrou);
+    if (attendre && p->jetons == 0 && !p->erreur) {
+        double debut = maintenant();
+        while (p->jetons == 0 && !p->erreur) {
+            pthread_cond_wait(&p->cond_jetons, &p->verrou);
+        }
+        p->attente_lecture += maintenant() - debut;
+    }
+    int resultat = p->erreur ? -1 : p->jetons > 0;
+    if (resultat == 1) {
+        p->jetons--;
+    }
+    pthread_mutex_unlock(&p->verrou);
+    return resultat;
+}
+
+static void rendre_jeton(struct Pipeline* p) {
+    pthread_mutex_lock(&p->verrou);
+    p->jetons++;
+    pthread_cond_signal(&p->cond_jetons);
+    pthread_mutex_unlock(&p->verrou);
+}
+
+static void liberer_tache(struct Tache* t) {
+    memoire_liberer(t->entree);
+    memoire_liberer(t->sortie);
+    memoire_liberer(t);
+}
+
+/* Transmet un bloc lu aux travailleurs (la place est déjà réservée, l'anneau ne déborde pas) */
+static void deposer_a_calculer(struct Pipeline* p, struct Tache* t) {
+    pthread_mutex_lock(&p->verrou);
+    p->a_calculer[(p->debut_a_calculer + p->nb_a_calculer) % p->profondeur] = t;
+    p->nb_a_calculer++;
+    pthread_cond_signal(&p->cond_calcul);
+    pthread_mutex_unlock(&p->verrou);
+}
+
+/**
+ * Fonction : lire_sequentiel
+ * Description : Lit taille octets à la position courante d'une entrée sans positions, en relançant
+ *               les lectures partielles.
+ * Retourne : Le nombre d'octets lus (moins que taille à la fin de l'entrée), -1 en cas d'erreur.
+ */
+static long lire_sequentiel(int fd, unsigned char* tampon, size_t taille) {
+    size_t lus = 0;
+    while (lus < taille) {
+        ssize_t n = read(fd, tampon + lus, taille - lus);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            perror("Erreur de lecture");
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        lus += (size_t)n;
+    }
+    return (long)lus;
+}
+
+/**
+ * Fonction : lire_exactement
+ * Description : Lit taille octets à la position decalage en attendant la fin de l'opération,
+ *               en relançant les lectures partielles. Une entrée sans positions est lue là où elle en est.
+ * Retourne : Le nombre d'octets lus (moins que taille à la fin du fichier), -1 en cas d'erreur.
+ */
+static long lire_exactement(struct Pipeline* p, struct FileES* es, unsigned char* tampon, size_t taille,
+                            uint64_t decalage) {
+    if (p->entree_sequentielle) {
+        return lire_sequentiel(p->fd_entree, tampon, taille);
+    }
+    const int fd = p->fd_entree;
+    size_t lus = 0;
+    while (lus < taille) {
+        struct CompletionES completion;
+        if (es_soumettre(es, 0, fd, tampon + lus, taille - lus, decalage + lus, 0) != 0 ||
+            es_attendre(es, &completion) != 0 || completion.resultat < 0) {
+            perror("Erreur de lecture");
+            return -1;
+        }
+        if (completion.resultat == 0) {
+            break;
+        }
+        lus += (size_t)completion.resultat;
+    }
+    return (long)lus;
+}
+
+/**
+ * Fonction : lire_tranches
+ * Description : Étage de lecture en DECOUPAGE_TRANCHES : jusqu'à ES_LECTURES_EN_VOL lectures de
+ *               tranches consécutives sont en vol, chacune dès qu'une place est libre dans le pipeline.
+ *               Une lecture partielle est relancée pour le reste de sa tranche ; une lecture vide
+ *               marque la fin du fichier.
+ * Retourne : Le nombre de blocs transmis, ou -1 en cas d'erreur.
+ */
+static long long lire_tranches(struct Pipeline* p, struct FileES* es) {
+    const size_t taille_tranche = p->parametres->taille_tranche;
+    uint64_t prochaine = 0;          // Index de la prochaine tranche à lire
+    long long transmises = 0;
+    uint64_t index_max = 0;
+    int fin = 0, erreur = 0;
+
+    while (!erreur && (!fin || es->en_vol > 0)) {
+        // Nouvelles lectures, sans attendre de place tant que d'autres lectures sont en vol
+        while (!fin && es->en_vol < es->profondeur) {
+            int jeton = prendre_jeton(p, es->en_vol == 0);
+            if (jeton <= 0) {
+                erreur = jeton < 0;
+                break;
+            }
+            struct Tache* t = memoire_allouer_zero(1, sizeof(struct Tache));
+            if (t) {
+                t->entree = memoire_allouer(taille_tranche);
+            }
+            if (!t || !t->entree) {
+                fprintf(stderr, "Mémoire insuffisante pour le pipeline\n");
+                memoire_liberer(t);
+                erreur = 1;
+                break;
+            }
+            t->index = prochaine++;
+            if (es_soumettre(es, 0, p->fd_entree, t->entree, taille_tranche,
+                             p->decalage_entree + t->index * taille_tranche, (uint64_t)(uintptr_t)t) != 0) {
+                perror("Erreur de lecture");
+                liberer_tache(t);
+                erreur = 1;
+            }
+        }
+        if (es->en_vol == 0) {
+            break;
+        }
+
+        struct CompletionES completion;
+        if (es_attendre(es, &completion) != 0) {
+            perror("Erreur de lecture");
+            erreur = 1;
+            break;
+        }
+        struct Tache* t = (struct Tache*)(uintptr_t)completion.etiquette;
+        if (completion.resultat < 0) {
+            fprintf(stderr, "Erreur de lecture : %s\n", strerror((int)-completion.resultat));
+            erreur = 1;
+        } else if (completion.resultat > 0 && t->taille_entree + (size_t)completion.resultat < taille_tranche) {
+            // Lecture partielle : on relance pour le reste de la tranche
+            t->taille_entree += (size_t)completion.resultat;
+            if (es_soumettre(es, 0, p->fd_entree, t->entree + t->taille_entree, taille_tranche - t->taille_entree,
+                             p->decalage_entree + t->index * taille_tranche + t->taille_entree,
+                             completion.etiquette) == 0) {
+                continue;
+            }
+            perror("Erreur de lecture");
+            erreur = 1;
+        } else {
+            t->taille_entree += (size_t)completion.resultat;
+            if (completion.resultat == 0) {
+                fin = 1;
+            }
+            if (t->taille_entree > 0) {
+                p->octets_lus += t->taille_entree;
+                if (t->index > index_max) {
+                    index_max = t->index;
+                }
+                transmises++;
+                deposer_a_calculer(p, t);
+                continue;
+            }
+        }
+        liberer_tache(t);
+        rendre_jeton(p);
+    }
+
+    // En cas d'erreur, les lectures en vol sont attendues avant de libérer leurs tampons
+    struct CompletionES completion;
+    while (es->en_vol > 0 && es_attendre(es, &completion) == 0) {
+        liberer_tache((struct Tache*)(uintptr_t)completion.etiquette);
+    }
+    // Les tranches transmises doivent être consécutives (sinon le fichier a changé pendant la lecture)
+    if (!erreur && transmises > 0 && index_max + 1 != (uint64_t)transmises) {
+        fprintf(stderr, "Le fichier d'entrée a changé pendant la lecture\n");
+        erreur = 1;
+    }
+    return erreur ? -1 : transmises;
+}
+
+/**
+ * Fonction : lire_tranches_sequentielles
+ * Description : Étage de lecture en DECOUPAGE_TRANCHES pour une entrée sans positions : une seule
+ *               lecture à la fois, de la position courante, pour que les tranches restent dans
+ *               l'ordre de l'entrée.
+ * Retourne : Le nombre de blocs transmis, ou -1 en cas d'erreur.
+ */
+static long long lire_tranches_sequentielles(struct Pipeline* p) {
+    const size_t taille_tranche = p->parametres->taille_tranche;
+    long long transmises = 0;
+
+    for (;;) {
+        if (prendre_jeton(p, 1) < 0) {
+            return -1;
+        }
+        struct Tache* t = memoire_allouer_zero(1, sizeof(struct Tache));
+        if (t) {
+            t->entree = memoire_allouer(taille_tranche);
+        }
+        if (!t || !t->entree) {
+            fprintf(stderr, "Mémoire insuffisante pour le pipeline\n");
+            memoire_liberer(t);
+            return -1;
+        }
+        long lus = lire_sequentiel(p->fd_entree, t->entree, taille_tranche);
+        if (lus <= 0) {
+            liberer_tache(t);
+            rendre_jeton(p);
+            return lus < 0 ? -1 : transmises;
+        }
+        t->index = (uint64_t)transmises++;
+        t->taille_entree = (size_t)lus;
+        p->octets_lus += t->taille_entree;
+        deposer_a_calculer(p, t);
+        if ((size_t)lus < taille_tranche) {
+            return transmises; // Fin de l'entrée
+        }
+    }
+}
+
+/**
+ * Fonction : lire_blocs
+ * Description : Étage de lecture en DECOUPAGE_BLOCS : chaque lecture prend le corps d'un bloc et
+ *               l'en-tête du suivant. Les tailles annoncées sont bornées avant toute allocation.
+ * Retourne : Le nombre de blocs transmis, ou -1 en cas d'erreur.
+ */
+static long long lire_blocs(struct Pipeline* p, struct FileES* es) {
+    const size_t taille_en_tete = sizeof(struct EnTeteBloc);
+    uint64_t position = p->decalage_entree;
+    long long transmis = 0;
+    struct EnTeteBloc en_tete;
+
+    if (lire_exactement(p, es, (unsigned char*)&en_tete, taille_en_tete, position) != (long)taille_en_tete) {
+        fprintf(stderr, "Flux tronqué : marqueur de fin absent\n");
+        return -1;
+    }
+    position += taille_en_tete;
+
+    while (en_tete.taille_originale != 0) {
+        if (en_tete.taille_originale > p->parametres->taille_originale_max || en_tete.taille_compressee == 0 ||
+            en_tete.taille_compressee > p->parametres->taille_compressee_max) {
+            fprintf(stderr, "Bloc invalide : tailles hors limites (%u / %u octets)\n",
+                    en_tete.taille_originale, en_tete.taille_compressee);
+            return -1;
+        }
+        if (prendre_jeton(p, 1) < 0) {
+            return -1;
+        }
+        struct Tache* t = memoire_allouer_zero(1, sizeof(struct Tache));
+        if (t) {
+            t->entree = memoire_allouer(taille_en_tete + en_tete.taille_compressee + taille_en_tete);
+        }
+        if (!t || !t->entree) {
+            fprintf(stderr, "Mémoire insuffisante pour un bloc de %u octets\n", en_tete.taille_compressee);
+            memoire_liberer(t);
+            return -1;
+        }
+
+        // Corps du bloc et en-tête du suivant en une seule lecture
+        size_t a_lire = en_tete.taille_compressee + taille_en_tete;
+        memcpy(t->entree, &en_tete, taille_en_tete);
+        if (lire_exactement(p, es, t->entree + taille_en_tete, a_lire, position) != (long)a_lire) {
+            fprintf(stderr, "Flux tronqué : bloc incomplet\n");
+            liberer_tache(t);
+            return -1;
+        }
+        position += a_lire;
+        memcpy(&en_tete, t->entree + taille_en_tete + en_tete.taille_compressee, taille_en_tete);
+
+        t->index = (uint64_t)transmis++;
+        t->taille_entree = taille_en_tete + ((struct EnTeteBloc*)t->entree)->taille_compressee;
+        deposer_a_calculer(p, t);
+    }
+    p->octets_lus = position - p->decalage_entree;
+    return transmis;
+}
+
+// Étage de lecture
+static void* thread_lecture(void* argument) {
+    struct Pipeline* p = argument;
+    compteur_memoire_attacher(p->compteur);
+    double debut = maintenant();
+    struct FileES es;
+    es_initialiser(&es, p->entree_sequentielle ? 1 : ES_LECTURES_EN_VOL, p->parametres->es_bloquantes);
+
+    long long nb_blocs;
+    if (p->parametres->decoupage == DECOUPAGE_BLOCS) {
+        nb_blocs = lire_blocs(p, &es);
+    } else {
+        nb_blocs = p->entree_sequentielle ? lire_tranches_sequentielles(p) : lire_tranches(p, &es);
+    }
+    es_liberer(&es);
+    p->duree_lecture = maintenant() - debut;
+
+    if (nb_blocs < 0) {
+        signaler_erreur(p);
+        return NULL;
+    }
+    pthread_mutex_lock(&p->verrou);
+    p->nb_total = (uint64_t)nb_blocs;
+    p->lecture_finie = 1;
+    pthread_cond_broadcast(&p->cond_calcul);
+    pthread_cond_broadcast(&p->cond_ecriture);
+    pthread_mutex_unlock(&p->verrou);
+    return NULL;
+}
+
+// Étage de calcul : chaque travailleur prend le plus ancien bloc lu
+static void* thread_calcul(void* argument) {
+    struct Pipeline* p = argument;
+    compteur_memoire_attacher(p->compteur);
+    for (;;) {
+        pthread_mutex_lock(&p->verrou);
+        while (p->nb_a_calculer == 0 && !p->lecture_finie && !p->erreur) {
+            pthread_cond_wait(&p->cond_calcul, &p->verrou);
+        }
+        if (p->erreur || p->nb_a_calculer == 0) {
+            pthread_mutex_unlock(&p->verrou);
+            return NULL;
+        }
+        struct Tache* t = p->a_calculer[p->debut_a_calculer];
+        p->debut_a_calculer = (p->debut_a_calculer + 1) % p->profondeur;
+        p->nb_a_calculer--;
+        pthread_mutex_unlock(&p->verrou);
+
+        double debut = maintenant();
+        t->sortie = p->parametres->traitement(t->entree, t->taille_entree, &t->taille_sortie, p->parametres->contexte);
+        double duree = maintenant() - debut;
+        memoire_liberer(t->entree);
+        t->entree = NULL;
+
+        pthread_mutex_lock(&p->verrou);
+        p->temps_calcul += duree;
+        if (t->sortie) {
+            p->calculees[t->index % p->profondeur] = t;
+            pthread_cond_signal(&p->cond_ecriture);
+            pthread_mutex_unlock(&p->verrou);
+        } else {
+            pthread_mutex_unlock(&p->verrou);
+            liberer_tache(t);
+            signaler_erreur(p);
+            return NULL;
+        }
+    }
+}
+
+/**
+ * Fonction : terminer_ecriture
+ * Description : Attend une écriture en vol ; la relance si elle est partielle, sinon libère son
+ *               bloc et sa place dans le pipeline.
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur d'écriture.
+ */
+static int terminer_ecriture(struct Pipeline* p, struct FileES* es) {
+    struct CompletionES completion;
+    if (es_attendre(es, &completion) != 0) {
+        perror("Erreur d'écriture");
+        return -1;
+    }
+    struct Tache* t = (struct Tache*)(uintptr_t)completion.etiquette;
+    if (completion.resultat <= 0) {
+        fprintf(stderr, "Erreur d'écriture : %s\n",
+                completion.resultat < 0 ? strerror((int)-completion.resultat) : "aucun octet écrit");
+        liberer_tache(t);
+        return -1;
+    }
+    t->ecrit += (size_t)completion.resultat;
+    if (t->ecrit < t->taille_sortie) {
+        if (es_soumettre(es, 1, p->fd_sortie, t->sortie + t->ecrit, t->taille_sortie - t->ecrit,
+                         t->decalage + t->ecrit, completion.etiquette) != 0) {
+            perror("Erreur d'écriture");
+            liberer_tache(t);
+            return -1;
+        }
+        return 0;
+    }
+    liberer_tache(t);
+    rendre_jeton(p);
+    return 0;
+}
+
+// Étage d'écriture : les blocs sont écrits dans l'ordre de l'entrée, plusieurs écritures en vol
+static void* thread_ecriture(void* argument) {
+    struct Pipeline* p = argument;
+    compteur_memoire_attacher(p->compteur);
+    struct FileES es;
+    es_initialiser(&es, ES_ECRITURES_EN_VOL, p->parametres->es_bloquantes);
+    uint64_t prochain = 0;
+    uint64_t position = p->decalage_sortie;
+    int erreur = 0;
+
+    while (!erreur) {
+        pthread_mutex_lock(&p->verrou);
+        struct Tache** c = &p->calculees[prochain % p->profondeur];
+        // On n'attend le prochain bloc que si aucune écriture n'est à terminer
+        if (*c == NULL && !p->erreur && !(p->lecture_finie && prochain == p->nb_total) && es.en_vol == 0) {
+            double debut = maintenant();
+            while (*c == NULL && !p->erreur && !(p->lecture_finie && prochain == p->nb_total)) {
+                pthread_cond_wait(&p->cond_ecriture, &p->verrou);
+            }
+            p->attente_ecriture += maintenant() - debut;
+        }
+        struct Tache* t = p->erreur ? NULL : *c;
+        if (t) {
+            *c = NULL;
+        }
+        int fini = p->erreur || (p->lecture_finie && prochain == p->nb_total);
+        pthread_mutex_unlock(&p->verrou);
+
+        if (t) {
+            if (es.en_vol == es.profondeur && terminer_ecriture(p, &es) != 0) {
+                liberer_tache(t);
+                erreur = 1;
+                break;
+            }
+            t->decalage = position;
+            position += t->taille_sortie;
+            p->octets_ecrits += t->taille_sortie;
+            prochain++;
+            if (t->taille_sortie == 0) {
+                liberer_tache(t);
+                rendre_jeton(p);
+            } else if (es_soumettre(&es, 1, p->fd_sortie, t->sortie, t->taille_sortie, t->decalage,
+                                    (uint64_t)(uintptr_t)t) != 0) {
+                perror("Erreur d'écriture");
+                liberer_tache(t);
+                erreur = 1;
+            }
+        } else if (es.en_vol > 0) {
+            erreur = terminer_ecriture(p, &es) != 0;
+        } else if (fini) {
+            break;
+        }
+    }
+
+    // Écritures encore en vol (en cas d'erreur)
+    struct CompletionES completion;
+    while (es.en_vol > 0 && es_attendre(&es, &completion) == 0) {
+        liberer_tache((struct Tache*)(uintptr_t)completion.etiquette);
+    }
+    pthread_mutex_lock(&p->verrou);
+    p->methode_es = es_methode(&es);
+    pthread_mutex_unlock(&p->verrou);
+    es_liberer(&es);
+    if (erreur) {
+        signaler_erreur(p);
+    }
+    return NULL;
+}
+
+// Nombre de travailleurs et profondeur effectifs (les valeurs 0 des paramètres sont remplacées)
+static void dimensions_pipeline(const struct ParametresPipeline* parametres, int* nb_travailleurs, int* profondeur) {
+    *nb_travailleurs = parametres->nb_travailleurs;
+    if (*nb_travailleurs <= 0) {
+        *nb_travailleurs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if (*nb_travailleurs <= 0) {
+            *nb_travailleurs = 1;
+        }
+    }
+    *profondeur = parametres->profondeur > 0 ? parametres->profondeur : 2 * *nb_travailleurs + 2;
+}
+
+/**
+ * Fonction : borne_memoire_pipeline
+ * Description : Calcule la mémoire de travail maximale d'executer_pipeline, telle que la mesure
+ *               memoire_pic : les deux anneaux, puis, pour chacun des profondeur blocs en mémoire,
+ *               sa tâche, son entrée et sa sortie (l'entrée n'est libérée qu'une fois la sortie
+ *               produite), plus la mémoire propre à chaque travailleur pendant un traitement.
+ * Paramètres :
+ * - parametres : Paramètres qui seront passés à executer_pipeline.
+ * - taille_sortie_max : Plus grande sortie allouée par le traitement pour un bloc.
+ * - memoire_travailleur : Mémoire allouée et libérée par le traitement d'un bloc, en plus de sa
+ *                         sortie, surcoût de memoire_allouer compris.
+ * Retourne : La borne, en octets.
+ */
+size_t borne_memoire_pipeline(const struct ParametresPipeline* parametres, size_t taille_sortie_max,
+                              size_t memoire_travailleur) {
+    int nb_travailleurs, profondeur;
+    dimensions_pipeline(parametres, &nb_travailleurs, &profondeur);
+    size_t taille_entree_max = parametres->decoupage == DECOUPAGE_TRANCHES
+        ? parametres->taille_tranche
+        : 2 * sizeof(struct EnTeteBloc) + parametres->taille_compressee_max;
+
+    size_t anneaux = 2 * (MEMOIRE_SURCOUT + profondeur * sizeof(struct Tache*)) +
+                     MEMOIRE_SURCOUT + nb_travailleurs * sizeof(pthread_t);
+    size_t bloc = 3 * MEMOIRE_SURCOUT + sizeof(struct Tache) + taille_entree_max + taille_sortie_max;
+    return anneaux + profondeur * bloc + nb_travailleurs * memoire_travailleur;
+}
+
+/**
+ * Fonction : executer_pipeline
+ * Description : Traite l'entrée bloc par bloc avec un thread de lecture, nb_travailleurs threads
+ *               de calcul et un thread d'écriture qui remet les sorties dans l'ordre de l'entrée.
+ *               Au plus profondeur blocs sont en mémoire à la fois ; un étage plus lent que les
+ *               autres les fait donc attendre au lieu de faire grossir la mémoire.
+ *               Une entrée qui n'est ni un fichier ordinaire ni un périphérique bloc (tube, terminal)
+ *               ne peut pas être lue par positions : elle est lue dans l'ordre, une lecture à la fois.
+ * Paramètres :
+ * - fd_entree, decalage_entree : Fichier à traiter et position de départ ; pour une entrée sans
+ *   positions, les decalage_entree premiers octets doivent déjà avoir été consommés.
+ * - fd_sortie, decalage_sortie : Fichier de sortie et position où écrire la première sortie.
+ * - parametres : Découpage, traitement et dimensions du pipeline.
+ * - stats : Reçoit les mesures du pipeline (peut être NULL).
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur de lecture, de traitement ou d'écriture.
+ */
+int executer_pipeline(int fd_entree, uint64_t decalage_entree, int fd_sortie, uint64_t decalage_sortie,
+                      const struct ParametresPipeline* parametres, struct StatistiquesPipeline* stats) {
+    struct Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.parametres = parametres;
+    p.fd_entree = fd_entree;
+    p.fd_sortie = fd_sortie;
+    p.decalage_entree = decalage_entree;
+    p.decalage_sortie = decalage_sortie;
+
+    // Des lectures en vol à plusieurs positions d'un tube reviendraient dans le désordre
+    struct stat infos;
+    if (fstat(fd_entree, &infos) != 0) {
+        perror("Erreur de lecture");
+        return -1;
+    }
+    p.entree_sequentielle = !S_ISREG(infos.st_mode) && !S_ISBLK(infos.st_mode);
+
+    int nb_travailleurs;
+    dimensions_pipeline(parametres, &nb_travailleurs, &p.profondeur);
+    p.jetons = p.profondeur;
+
+    // Toutes les allocations du pipeline et des traitements sont comptées pour cet appel
+    struct CompteurMemoire compteur;
+    compteur_memoire_initialiser(&compteur);
+    p.compteur = &compteur;
+    struct CompteurMemoire* compteur_precedent = compteur_memoire_attacher(&compteur);
+
+    p.a_calculer = memoire_allouer_zero(p.profondeur, sizeof(struct Tache*));
+    p.calculees = memoire_allouer_zero(p.profondeur, sizeof(struct Tache*));
+    pthread_t* travailleurs = memoire_allouer(nb_travailleurs * sizeof(pthread_t));
+    if (!p.a_calculer || !p.calculees || !travailleurs) {
+        fprintf(stderr, "Mémoire insuffisante pour le pipeline\n");
+        memoire_liberer(p.a_calculer);
+        memoire_liberer(p.calculees);
+        memoire_liberer(travailleurs);
+        compteur_memoire_attacher(compteur_precedent);
+        return -1;
+    }
+    pthread_mutex_init(&p.verrou, NULL);
+    pthread_cond_init(&p.cond_jetons, NULL);
+    pthread_cond_init(&p.cond_calcul, NULL);
+    pthread_cond_init(&p.cond_ecriture, NULL);
+
+    double debut = maintenant();
+    pthread_t lecture, ecriture;
+    int lecture_lancee = pthread_create(&lecture, NULL, thread_lecture, &p) == 0;
+    int ecriture_lancee = pthread_create(&ecriture, NULL, thread_ecriture, &p) == 0;
+    int lances = 0;
+    while (lances < nb_travailleurs && pthread_create(&travailleurs[lances], NULL, thread_calcul, &p) == 0) {
+        lances++;
+    }
+    if (!lecture_lancee || !ecriture_lancee || lances == 0) {
+        fprintf(stderr, "Impossible de lancer les threads du pipeline\n");
+        signaler_erreur(&p);
+    }
+    if (lecture_lancee) {
+        pthread_join(lecture, NULL);
+    }
+    for (int i = 0; i < lances; i++) {
+        pthread_join(travailleurs[i], NULL);
+    }
+    if (ecriture_lancee) {
+        pthread_join(ecriture, NULL);
+    }
+    double duree = maintenant() - debut;
+
+    // Blocs restés dans les anneaux après une erreur
+    for (int i = 0; i < p.profondeur; i++) {
+        if (p.calculees[i]) {
+            liberer_tache(p.calculees[i]);
+        }
+    }
+    for (int i = 0; i < p.nb_a_calculer; i++) {
+        liberer_tache(p.a_calculer[(p.debut_a_calculer + i) % p.profondeur]);
+    }
+
+    if (stats) {
+        stats->octets_lus = p.octets_lus;
+        stats->octets_ecrits = p.octets_ecrits;
+        stats->nb_blocs = p.nb_total;
+        stats->nb_travailleurs = lances;
+        stats->duree = duree;
+        stats->occupation_lecture = duree > 0 ? (p.duree_lecture - p.attente_lecture) / duree : 0;
+        stats->occupation_calcul = duree > 0 && lances > 0 ? p.temps_calcul / (lances * duree) : 0;
+        stats->occupation_ecriture = duree > 0 ? 1.0 - p.attente_ecriture / duree : 0;
+        stats->methode_es = p.methode_es ? p.methode_es : "bloquante";
+        stats->memoire_pic = atomic_load(&compteur.pic);
+    }
+
+    int erreur = p.erreur;
+    pthread_cond_destroy(&p.cond_ecriture);
+    pthread_cond_destroy(&p.cond_calcul);
+    pthread_cond_destroy(&p.cond_jetons);
+    pthread_mutex_destroy(&p.verrou);
+    memoire_liberer(travailleurs);
+    memoire_liberer(p.calculees);
+    memoire_liberer(p.a_calculer);
+    compteur_memoire_attacher(compteur_precedent);
+    return erreur ? -1 : 0;
+}
+
+/**
+ * Fonction : afficher_statistiques_pipeline
+ * Description : Affiche la durée, le débit et l'occupation de chaque étage. L'étage le plus
+ *               occupé est celui qui limite le débit.
+ * Paramètres :
+ * - stats : Mesures rendues par executer_pipeline.
+ */
+void afficher_statistiques_pipeline(const struct StatistiquesPipeline* stats) {
+    printf("Pipeline : %d travailleur(s), E/S %s, %llu bloc(s) en %.3f s (%.1f Mo/s lus)\n",
+           stats->nb_travailleurs, stats->methode_es, stats->nb_blocs, stats->duree,
+           stats->duree > 0 ? stats->octets_lus / stats->duree / (1024 * 1024) : 0.0);
+    printf("Occupation : lecture %.0f %%, calcul %.0f %%, écriture %.0f %%\n",
+           100 * stats->occupation_lecture, 100 * stats->occupation_calcul, 100 * stats->occupation_ecriture);
+    printf("Mémoire de travail : %.1f Ko au plus fort\n", stats->memoire_pic / 1024.0);
+}
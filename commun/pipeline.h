@@ -0,0 +1,54 @@
+/* pipeline.h - Traitement d'un fichier par blocs en trois étages : un thread de lecture, des
+ * travailleurs qui compressent ou décompressent, et un thread d'écriture qui remet les blocs
+ * dans l'ordre. Les étages communiquent par des anneaux bornés : le nombre de blocs en mémoire
+ * ne dépasse jamais la profondeur du pipeline. Les lectures et écritures passent par io_uring
+ * quand il est disponible (voir es_async.h). */
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Traitement d'un bloc par un travailleur : renvoie la sortie allouée avec memoire_allouer et sa
+ * taille, ou NULL en cas d'erreur (le message est affiché par le traitement). Appelé en parallèle. */
+typedef unsigned char* (*TraitementBloc)(const unsigned char* entree, size_t taille,
+                                         size_t* taille_sortie, void* contexte);
+
+enum DecoupageEntree {
+    DECOUPAGE_TRANCHES, // Entrée brute, découpée en tranches de taille_tranche octets
+    DECOUPAGE_BLOCS     // Suite de blocs (struct EnTeteBloc puis corps) terminée par un en-tête nul ;
+                        // le traitement reçoit l'en-tête et le corps, sans que le CRC du bloc soit vérifié
+};
+
+struct ParametresPipeline {
+    enum DecoupageEntree decoupage;
+    size_t taille_tranche;                                 // DECOUPAGE_TRANCHES
+    uint32_t taille_originale_max, taille_compressee_max;  // DECOUPAGE_BLOCS, voir lire_bloc
+    TraitementBloc traitement;
+    void* contexte;                                        // Transmis tel quel au traitement
+    int nb_travailleurs;                                   // 0 : un par cœur
+    int profondeur;                                        // Blocs en mémoire au plus, 0 : 2 par travailleur + 2
+    int es_bloquantes;                                     // 1 : pread/pwrite même si io_uring est disponible
+};
+
+struct StatistiquesPipeline {
+    unsigned long long octets_lus;     // Octets consommés (marqueur de fin compris en DECOUPAGE_BLOCS)
+    unsigned long long octets_ecrits;
+    unsigned long long nb_blocs;
+    int nb_travailleurs;
+    double duree;                      // Secondes, de la première lecture à la dernière écriture
+    /* Part du temps où chaque étage travaille (le reste, il attend les autres) ;
+     * pour le calcul, moyenne sur les travailleurs */
+    double occupation_lecture, occupation_calcul, occupation_ecriture;
+    const char* methode_es;            // "io_uring" ou "bloquante"
+    size_t memoire_pic;                // Octets alloués au plus fort par le pipeline et les traitements
+};
+
+/* Prototypes de fonctions */
+int executer_pipeline(int fd_entree, uint64_t decalage_entree, int fd_sortie, uint64_t decalage_sortie,
+                      const struct ParametresPipeline* parametres, struct StatistiquesPipeline* stats);
+size_t borne_memoire_pipeline(const struct ParametresPipeline* parametres, size_t taille_sortie_max,
+                              size_t memoire_travailleur);
+void afficher_statistiques_pipeline(const struct StatistiquesPipeline* stats);
+
+#endif
@@ -2,32 +2,33 @@
 #include <stdio.h>    
 #include <fcntl.h>    // Pour les opérations sur les fichiers
 #include <string.h>   // Pour les fonctions de manipulation de chaînes
+#include <time.h>     // Pour la durée de décompression de l'ancien format
+#include <unistd.h>   // Pour pread et pwrite
+#include <sys/stat.h> // Pour la taille du fichier décompressé
 #include "table.h"    // Pour inclure la définition de la structure de la table LZW
-
-// Déclaration des pointeurs de fichiers pour l'entrée et la sortie
-FILE *fichier_entree, *fichier_sortie;
-
-// Variable globale pour indiquer si la table LZW est pleine
-int table_complete = 1;
-
-// Structure représentant une entrée de la table LZW
-struct EntreeLZW table_lzw[256];
+#include "../commun/crc32c.h" // Pour les sommes de contrôle des blocs
+#include "../commun/pipeline.h" // Pour la lecture, le calcul et l'écriture en parallèle
+#include "../commun/memoire.h" // Pour compter la mémoire de travail
 
 
 /**
  * Fonction : initialiser_table
  * Description : Initialise la table LZW avec les caractères ASCII de 0 à 127 et des entrées vides après.
- * Paramètres : Aucun.
+ *               Appelée au début de chaque bloc : les blocs sont indépendants.
+ * Paramètres :
+ * - table : La table à initialiser.
  */
 
-void initialiser_table() {
+void initialiser_table(struct TableLZW *table) {
+    table->table_complete = 1; // La table est de nouveau vide
+    table->prochain_libre = 128;
     // Remplit la table avec les caractères ASCII de 0 à 127
     for (int i = 0; i < 128; i++) {
-        table_lzw[i].code_base = table_lzw[i].caractere = (unsigned char)i; // Code et caractère initialisés à i
+        table->entrees[i].code_base = table->entrees[i].caractere = (unsigned char)i; // Code et caractère initialisés à i
     }
     // Remplit le reste de la table avec des caractères nuls
     for (int i = 128; i < 256; i++) {
-        table_lzw[i].code_base = table_lzw[i].caractere = '\0'; // Indique une entrée vide
+        table->entrees[i].code_base = table->entrees[i].caractere = '\0'; // Indique une entrée vide
     }
 }
 
@@ -35,222 +36,1403 @@ void initialiser_table() {
 
 
 
-/**
- * Fonction : rechercher_entree
- * Description : Recherche une entrée dans la table LZW.
- * Paramètres : 
- * - caractere : Le caractère à rechercher.
- * - code_base : Le code de base à vérifier.
- * - index_table : Pointeur vers la variable qui recevra l'index trouvé ou vide.
- * Retourne : 1 si trouvé, 0 sinon.
- */
-
-int rechercher_entree(unsigned char caractere, unsigned char code_base, int *index_table) {
-    // Parcourt la table à partir de l'index 128
-    for (int i = 128; i < 256; i++) {
-        // Vérifie si l'entrée correspond au code de base et au caractère
-        if (table_lzw[i].code_base == code_base && table_lzw[i].caractere == caractere) {
-            *index_table = i; // Renvoie l'index de l'entrée trouvée
-            return 1; // Trouvé
-        }
-        // Vérifie si l'entrée est vide
-        if (table_lzw[i].caractere == '\0') {
-            *index_table = i; // Renvoie l'index de la première entrée vide
-            return 0; // Non trouvé
-        }
-    }
-    // Si aucune entrée n'est trouvée, la table est pleine
-    table_complete = 0; // La table est pleine
-    *index_table = (int)caractere; // Renvoie l'index du caractère
-    return 0; // Non trouvé
-}
-
-// on a une table et une fonction pour rechercher les caractere et les verifier si les caracteres correspondent
-
 /**
  * Fonction : ajouter_code
  * Description : Ajoute un nouveau code dans la table LZW.
  * Paramètres :
+ * - table : La table LZW du bloc en cours.
  * - caractere : Le caractère à ajouter.
  * - code_base : Le code de base associé.
  * - index_table : L'index où l'entrée doit être ajoutée.
  */
 
-void ajouter_code(unsigned char caractere, unsigned char code_base, int index_table) {
-    table_lzw[index_table].code_base = code_base; // Met à jour le code de base
-    table_lzw[index_table].caractere = caractere; // Met à jour le caractère
+void ajouter_code(struct TableLZW *table, unsigned char caractere, unsigned char code_base, int index_table) {
+    table->entrees[index_table].code_base = code_base; // Met à jour le code de base
+    table->entrees[index_table].caractere = caractere; // Met à jour le caractère
+    table->prochain_libre = index_table + 1; // L'entrée suivante devient la première libre
 }
 
-/**
- * Fonction : code_absent_dans_table
- * Description : Vérifie si un code est absent dans la table LZW.
- * Paramètres :
- * - code : Le code à vérifier.
- * Retourne : 1 si le code est absent, 0 sinon.
- */
-
-int code_absent_dans_table(unsigned char code) {
-    return table_lzw[code].caractere == '\0'; // Retourne vrai si l'entrée est vide
-}
-
-
 /**
  * Fonction : extraire_chaine
- * Description : Reconstruit une chaîne à partir d'un code et l'écrit dans le fichier de sortie.
+ * Description : Reconstruit une chaîne à partir d'un code et l'écrit dans le tampon de sortie.
+ *               Une chaîne compte au plus LZW_LONGUEUR_MAX caractères : chaque entrée ajoutée
+ *               prolonge d'un caractère une entrée plus ancienne.
  * Paramètres :
+ * - table : La table LZW du bloc en cours.
  * - code : Le code à extraire.
- * Retourne : Le dernier caractère extrait.
+ * - sortie : Pointeur vers la position d'écriture courante, avancée des octets écrits.
+ * - fin : Fin du tampon de sortie, jamais dépassée.
+ * Retourne : Le premier caractère de la chaîne extraite, ou -1 si la chaîne ne tient pas dans le tampon.
  */
-unsigned char extraire_chaine(unsigned char code) {
-    unsigned char chaine_temp[80] = {0}; // Tableau temporaire pour stocker la chaîne
-    static unsigned char caractere_temp; // Variable pour stocker le caractère temporaire
+int extraire_chaine(const struct TableLZW *table, unsigned char code, unsigned char **sortie, const unsigned char *fin) {
+    unsigned char chaine_temp[LZW_LONGUEUR_MAX] = {0}; // Tableau temporaire pour stocker la chaîne
+    unsigned char caractere_temp; // Variable pour stocker le caractère temporaire
 
     // Si le code est inférieur à 128, c'est un caractère de base
     if (code < 128) {
-        ECRIRE_CHAR(code); // Écrire le caractère dans le fichier de sortie
+        if (*sortie >= fin) {
+            return -1; // Plus de place dans le tampon
+        }
+        *(*sortie)++ = code; // Écrire le caractère dans le tampon de sortie
         return code; // Retourner le code
     }
 
     int i = 0; // Index pour la chaîne temporaire
     // Boucle pour reconstruire la chaîne à partir du code (faire une recherche dans la table > ASCII 127)
-    while (code > 127) {
-        caractere_temp = table_lzw[code].caractere; // Obtenir le caractère associé
+    while (code > 127 && i < LZW_LONGUEUR_MAX - 1) {
+        caractere_temp = table->entrees[code].caractere; // Obtenir le caractère associé
         chaine_temp[i++] = caractere_temp; // Ajouter le caractère à la chaîne
-        code = table_lzw[code].code_base; // Mettre à jour le code
+        code = table->entrees[code].code_base; // Mettre à jour le code
     }
     chaine_temp[i++] = code; // Ajouter le dernier caractère
+    if (code > 127 || fin - *sortie < i) {
+        return -1; // Chaîne trop longue ou plus de place dans le tampon
+    }
 
     // Écrire les caractères dans l'ordre inverse
     for (int j = i - 1; j >= 0; j--) {
-        ECRIRE_CHAR(chaine_temp[j]); // Écrire chaque caractère dans le fichier
+        *(*sortie)++ = chaine_temp[j]; // Écrire chaque caractère dans le tampon
     }
     return chaine_temp[i - 1]; // Retourner le dernier caractère
 }
 
 
+/* Format LZW3 : codes de largeur variable sur tout l'alphabet des octets.
+ * Les codes 0 à 255 désignent les octets, LZW_CODE_RAZ vide le dictionnaire et les entrées
+ * ajoutées commencent à LZW_PREMIER_CODE. Un code est écrit sur le nombre de bits nécessaire
+ * pour le plus grand code que le compresseur peut émettre à ce moment, de poids fort en premier. */
+
+// Largeur d'un code quand le dictionnaire du compresseur compte nb_entrees entrées
+static inline int largeur_code(int nb_entrees) {
+    int largeur = 32 - __builtin_clz((unsigned)(nb_entrees - 1));
+    return largeur < LZW_LARGEUR_MIN ? LZW_LARGEUR_MIN : largeur;
+}
+
+#ifdef LZW_DICTIONNAIRE_HACHAGE
+/* Dictionnaire du compresseur : table de hachage à adressage ouvert, indexée par le couple
+ * (code du préfixe, octet suivant). Deux cases par entrée possible : les sondes restent courtes.
+ * Conservée pour comparer avec le trie (compiler avec -DLZW_DICTIONNAIRE_HACHAGE). */
+struct DictionnaireLZW {
+    uint32_t *cles;     // (préfixe << 8 | octet) + 1, 0 pour une case vide
+    uint16_t *codes;    // Code de l'entrée rangée dans la case
+    uint32_t masque;    // Nombre de cases moins un
+    int decalage;       // 32 moins le nombre de bits d'index, pour le hachage
+    int prochain;       // Prochain code à attribuer
+};
+
+static int creer_dictionnaire(struct DictionnaireLZW *dico, int largeur_max) {
+    size_t nb_cases = (size_t)2 << largeur_max;
+    dico->cles = memoire_allouer_zero(nb_cases, sizeof(uint32_t));
+    dico->codes = memoire_allouer(nb_cases * sizeof(uint16_t));
+    dico->masque = (uint32_t)(nb_cases - 1);
+    dico->decalage = 32 - (largeur_max + 1);
+    dico->prochain = LZW_PREMIER_CODE;
+    return dico->cles && dico->codes ? 0 : -1;
+}
+
+static void vider_dictionnaire(struct DictionnaireLZW *dico) {
+    memset(dico->cles, 0, ((size_t)dico->masque + 1) * sizeof(uint32_t));
+    dico->prochain = LZW_PREMIER_CODE;
+}
+
+static void liberer_dictionnaire(struct DictionnaireLZW *dico) {
+    memoire_liberer(dico->cles);
+    memoire_liberer(dico->codes);
+}
+
+// Mémoire allouée au plus par un dictionnaire de largeur_max bits
+static size_t borne_dictionnaire(int largeur_max) {
+    return 2 * MEMOIRE_SURCOUT + ((size_t)2 << largeur_max) * (sizeof(uint32_t) + sizeof(uint16_t));
+}
+
+// Case de la chaîne (préfixe, octet), ou case vide où la ranger
+static inline uint32_t case_suite(const struct DictionnaireLZW *dico, uint32_t prefixe, unsigned char octet) {
+    uint32_t cle = (prefixe << 8 | octet) + 1;
+    uint32_t case_dico = (cle * 2654435761u) >> dico->decalage;
+    while (dico->cles[case_dico] != 0 && dico->cles[case_dico] != cle) {
+        case_dico = (case_dico + 1) & dico->masque;
+    }
+    return case_dico;
+}
+
+// Code de la chaîne préfixe + octet, -1 si elle n'est pas dans le dictionnaire
+static inline int chercher_suite(const struct DictionnaireLZW *dico, uint32_t prefixe, unsigned char octet) {
+    uint32_t case_dico = case_suite(dico, prefixe, octet);
+    return dico->cles[case_dico] != 0 ? dico->codes[case_dico] : -1;
+}
+
+// Ajoute la chaîne préfixe + octet (absente) sous le code dico->prochain ; n'échoue jamais (0)
+static inline int ajouter_suite(struct DictionnaireLZW *dico, uint32_t prefixe, unsigned char octet) {
+    uint32_t case_dico = case_suite(dico, prefixe, octet);
+    dico->cles[case_dico] = (prefixe << 8 | octet) + 1;
+    dico->codes[case_dico] = (uint16_t)dico->prochain++;
+    return 0;
+}
+
+#else
+/* Dictionnaire du compresseur : trie dont les nœuds sont les codes. Prolonger la chaîne en cours
+ * coûte au plus deux accès mémoire, quelle que soit la taille du dictionnaire.
+ *   - Les fils des 256 codes d'un octet, consultés au début de chaque chaîne, sont dans une table
+ *     directe de 256 x 256 codes.
+ *   - Tout autre code a une cellule de 32 bits qui décrit ses fils selon leur nombre : aucun
+ *     (cellule nulle) ; un seul, dont l'octet et le code sont dans la cellule elle-même ; de 2 à
+ *     TRIE_PETIT, rangés dans un petit nœud où l'octet est cherché en une comparaison de 64 bits ;
+ *     davantage, dans un grand nœud, tableau de 256 codes indexé par l'octet.
+ * La plupart des codes ont zéro ou un fils et les grands nœuds sont rares : sur du texte, le
+ * dictionnaire occupe moins de 200 Ko à 4K entrées et environ 1 Mo à 64K, et reste dans le cache L2.
+ * Les réserves de nœuds partent d'un seizième de leur taille maximale et doublent au besoin. */
+#define TRIE_PETIT 8
+
+#define CELLULE_UN 1u     // Type dans les bits 24 à 31 de la cellule, le reste est la valeur
+#define CELLULE_PETIT 2u  // Valeur : octet du fils (bits 16 à 23) et son code, ou indice du nœud
+#define CELLULE_GRAND 3u
+
+struct PetitNoeud {
+    unsigned char octets[TRIE_PETIT]; // Les fils occupent les premières places
+    uint16_t codes[TRIE_PETIT];       // 0 pour une place libre (un fils a un code d'au moins LZW_PREMIER_CODE)
+};
+
+struct DictionnaireLZW {
+    uint16_t (*racines)[256];      // Fils des codes 0 à 255, 0 si absent
+    uint16_t *journal;             // Cases de racines remplies (octet << 8 | octet suivant), pour les vider
+    uint32_t *cellules;            // Une par code possible
+    struct PetitNoeud *petits;
+    uint16_t (*grands)[256];       // Code du fils pour chaque octet, 0 si absent
+    uint32_t nb_journal, nb_petits, nb_grands; // Depuis la dernière remise à zéro
+    uint32_t capacite_petits, capacite_grands;
+    uint32_t max_petits, max_grands;
+    int prochain;                  // Prochain code à attribuer
+};
+
+/* Chaque petit nœud a au moins 2 fils et chaque grand nœud au moins TRIE_PETIT + 1, et un code
+ * n'est le fils que d'un nœud : ces nombres de nœuds suffisent */
+static inline uint32_t max_petits(int largeur_max) {
+    return ((uint32_t)1 << largeur_max) / 2 + 1;
+}
+
+static inline uint32_t max_grands(int largeur_max) {
+    return ((uint32_t)1 << largeur_max) / (TRIE_PETIT + 1) + 1;
+}
+
+static int creer_dictionnaire(struct DictionnaireLZW *dico, int largeur_max) {
+    size_t limite = (size_t)1 << largeur_max;
+    dico->max_petits = max_petits(largeur_max);
+    dico->max_grands = max_grands(largeur_max);
+    dico->capacite_petits = dico->max_petits / 16 + 1;
+    dico->capacite_grands = dico->max_grands / 16 + 1;
+    dico->racines = memoire_allouer_zero(256, sizeof(*dico->racines));
+    dico->journal = memoire_allouer(limite * sizeof(uint16_t));
+    dico->cellules = memoire_allouer_zero(limite, sizeof(uint32_t));
+    dico->petits = memoire_allouer(dico->capacite_petits * sizeof(struct PetitNoeud));
+    dico->grands = memoire_allouer(dico->capacite_grands * sizeof(*dico->grands));
+    dico->nb_journal = dico->nb_petits = dico->nb_grands = 0;
+    dico->prochain = LZW_PREMIER_CODE;
+    return dico->racines && dico->journal && dico->cellules && dico->petits && dico->grands ? 0 : -1;
+}
+
+static void vider_dictionnaire(struct DictionnaireLZW *dico) {
+    // Seules les cases remplies sont remises à zéro ; les nœuds sont initialisés à l'attribution
+    for (uint32_t i = 0; i < dico->nb_journal; i++) {
+        dico->racines[dico->journal[i] >> 8][dico->journal[i] & 0xFF] = 0;
+    }
+    memset(dico->cellules, 0, (size_t)dico->prochain * sizeof(uint32_t));
+    dico->nb_journal = dico->nb_petits = dico->nb_grands = 0;
+    dico->prochain = LZW_PREMIER_CODE;
+}
+
+static void liberer_dictionnaire(struct DictionnaireLZW *dico) {
+    memoire_liberer(dico->racines);
+    memoire_liberer(dico->journal);
+    memoire_liberer(dico->cellules);
+    memoire_liberer(dico->petits);
+    memoire_liberer(dico->grands);
+}
+
+// Double la réserve de nœuds si elle est pleine, sans dépasser maximum ; NULL si la mémoire manque
+static void *agrandir_reserve(void *zone, uint32_t *capacite, uint32_t utilises, uint32_t maximum, size_t taille_noeud) {
+    if (utilises < *capacite) {
+        return zone;
+    }
+    uint32_t capacite_nouvelle = *capacite * 2 < maximum ? *capacite * 2 : maximum;
+    void *nouvelle = memoire_reallouer(zone, capacite_nouvelle * taille_noeud);
+    if (nouvelle) {
+        *capacite = capacite_nouvelle;
+    }
+    return nouvelle;
+}
+
+// Plus grande taille d'une réserve de nœuds, ancienne et nouvelle zones comprises pendant un agrandissement
+static size_t borne_reserve(uint32_t maximum, size_t taille_noeud) {
+    uint32_t capacite = maximum / 16 + 1;
+    size_t pic = MEMOIRE_SURCOUT + capacite * taille_noeud;
+    while (capacite < maximum) {
+        uint32_t capacite_nouvelle = capacite * 2 < maximum ? capacite * 2 : maximum;
+        size_t pendant = 2 * MEMOIRE_SURCOUT + ((size_t)capacite + capacite_nouvelle) * taille_noeud;
+        pic = pendant > pic ? pendant : pic;
+        capacite = capacite_nouvelle;
+    }
+    return pic;
+}
+
+// Mémoire allouée au plus par un dictionnaire de largeur_max bits
+static size_t borne_dictionnaire(int largeur_max) {
+    size_t limite = (size_t)1 << largeur_max;
+    return 3 * MEMOIRE_SURCOUT + 256 * 256 * sizeof(uint16_t) + limite * (sizeof(uint16_t) + sizeof(uint32_t)) +
+           borne_reserve(max_petits(largeur_max), sizeof(struct PetitNoeud)) +
+           borne_reserve(max_grands(largeur_max), 256 * sizeof(uint16_t));
+}
+
+// Place de l'octet parmi les fils d'un petit nœud, TRIE_PETIT s'il n'y est pas
+static inline unsigned place_dans_petit(const struct PetitNoeud *noeud, unsigned char octet) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (unsigned mot = 0; mot < TRIE_PETIT; mot += 8) {
+        uint64_t octets;
+        memcpy(&octets, noeud->octets + mot, sizeof(octets));
+        uint64_t difference = octets ^ (octet * 0x0101010101010101ull); // Octet nul là où il est égal
+        uint64_t egaux = (difference - 0x0101010101010101ull) & ~difference & 0x8080808080808080ull;
+        // Seul le premier octet nul est détecté à coup sûr ; les places libres, à la fin, peuvent aussi
+        // correspondre (octet 0) mais leur code nul les écarte
+        if (egaux) {
+            unsigned place = mot + (unsigned)__builtin_ctzll(egaux) / 8;
+            return noeud->codes[place] != 0 ? place : TRIE_PETIT;
+        }
+    }
+    return TRIE_PETIT;
+#else
+    for (unsigned place = 0; place < TRIE_PETIT && noeud->codes[place] != 0; place++) {
+        if (noeud->octets[place] == octet) {
+            return place;
+        }
+    }
+    return TRIE_PETIT;
+#endif
+}
+
+// Code de la chaîne préfixe + octet, -1 si elle n'est pas dans le dictionnaire
+static inline int chercher_suite(const struct DictionnaireLZW *dico, uint32_t prefixe, unsigned char octet) {
+    if (prefixe < 256) {
+        uint16_t code = dico->racines[prefixe][octet];
+        return code ? code : -1;
+    }
+    // Les cas sont testés du plus coûteux au moins coûteux : le dernier ne demande qu'une comparaison
+    uint32_t cellule = dico->cellules[prefixe];
+    uint32_t valeur = cellule & 0xFFFFFF;
+    if (cellule >> 24 == CELLULE_GRAND) {
+        uint16_t code = dico->grands[valeur][octet];
+        return code ? code : -1;
+    }
+    if (cellule >> 24 == CELLULE_PETIT) {
+        const struct PetitNoeud *noeud = &dico->petits[valeur];
+        unsigned place = place_dans_petit(noeud, octet);
+        return place < TRIE_PETIT ? noeud->codes[place] : -1;
+    }
+    uint32_t attendue = CELLULE_UN << 24 | (uint32_t)octet << 16 | (valeur & 0xFFFF);
+    return cellule == attendue ? (int)(valeur & 0xFFFF) : -1;
+}
+
+/* Ajoute la chaîne préfixe + octet (absente) sous le code dico->prochain, en agrandissant le nœud
+ * si besoin. Retourne 0, ou -1 si la mémoire manque pour un nouveau nœud (le dictionnaire est inchangé). */
+static int ajouter_suite(struct DictionnaireLZW *dico, uint32_t prefixe, unsigned char octet) {
+    uint16_t code = (uint16_t)dico->prochain;
+    if (prefixe < 256) {
+        dico->racines[prefixe][octet] = code;
+        dico->journal[dico->nb_journal++] = (uint16_t)(prefixe << 8 | octet);
+        dico->prochain++;
+        return 0;
+    }
+    uint32_t *cellule = &dico->cellules[prefixe];
+    uint32_t valeur = *cellule & 0xFFFFFF;
+    switch (*cellule >> 24) {
+    case 0:
+        *cellule = CELLULE_UN << 24 | (uint32_t)octet << 16 | code;
+        break;
+    case CELLULE_UN: {
+        struct PetitNoeud *petits = agrandir_reserve(dico->petits, &dico->capacite_petits, dico->nb_petits,
+                                                     dico->max_petits, sizeof(struct PetitNoeud));
+        if (!petits) {
+            return -1;
+        }
+        dico->petits = petits;
+        struct PetitNoeud *noeud = &dico->petits[dico->nb_petits];
+        memset(noeud, 0, sizeof(*noeud));
+        noeud->octets[0] = (unsigned char)(valeur >> 16);
+        noeud->codes[0] = (uint16_t)valeur;
+        noeud->octets[1] = octet;
+        noeud->codes[1] = code;
+        *cellule = CELLULE_PETIT << 24 | dico->nb_petits++;
+        break;
+    }
+    case CELLULE_PETIT: {
+        struct PetitNoeud *noeud = &dico->petits[valeur];
+        unsigned place = 0;
+        while (place < TRIE_PETIT && noeud->codes[place] != 0) {
+            place++;
+        }
+        if (place < TRIE_PETIT) {
+            noeud->octets[place] = octet;
+            noeud->codes[place] = code;
+            break;
+        }
+        // Petit nœud plein : ses fils passent dans un grand nœud (le petit reste inutilisé jusqu'à
+        // la prochaine remise à zéro)
+        uint16_t (*grands)[256] = agrandir_reserve(dico->grands, &dico->capacite_grands, dico->nb_grands,
+                                                   dico->max_grands, sizeof(*dico->grands));
+        if (!grands) {
+            return -1;
+        }
+        dico->grands = grands;
+        uint16_t *grand = dico->grands[dico->nb_grands];
+        memset(grand, 0, sizeof(*dico->grands));
+        for (place = 0; place < TRIE_PETIT; place++) {
+            grand[noeud->octets[place]] = noeud->codes[place];
+        }
+        grand[octet] = code;
+        *cellule = CELLULE_GRAND << 24 | dico->nb_grands++;
+        break;
+    }
+    default:
+        dico->grands[valeur][octet] = code;
+        break;
+    }
+    dico->prochain++;
+    return 0;
+}
+#endif
+
+/* Écriture des codes : les bits en attente sont dans les bits de poids faible de acc */
+struct EcrivainBits {
+    unsigned char *sortie;
+    uint64_t acc;
+    int bits;
+};
+
+static inline void ecrire_code(struct EcrivainBits *e, uint32_t code, int largeur) {
+    e->acc = (e->acc << largeur) | code;
+    e->bits += largeur;
+    while (e->bits >= 8) {
+        e->bits -= 8;
+        *e->sortie++ = (unsigned char)(e->acc >> e->bits);
+    }
+}
+
+
 /**
- * Fonction : compresser_lzw
- * Description : Compresse un fichier avec l'algorithme LZW.
+ * Fonction : compresser_bloc_lzw_avec
+ * Description : Compresse un bloc d'octets en mémoire au format LZW3, avec un dictionnaire neuf.
+ *               Le CRC32C des données est calculé tranche par tranche juste avant que la tranche
+ *               soit parcourue par la boucle de compression, tant qu'elle est dans le cache.
  * Paramètres :
- * - fichier_entree_nom : Nom du fichier d'entrée à compresser.
- * - fichier_sortie_nom : Nom du fichier de sortie où la compression est écrite.
- * Retourne : Le taux de compression en pourcentage.
+ * - entree : Octets à compresser.
+ * - taille : Nombre d'octets (au moins 1).
+ * - largeur_max : Largeur maximale des codes (LZW_LARGEUR_MIN à LZW_LARGEUR_MAX) ; le dictionnaire
+ *                 compte au plus 2^largeur_max entrées.
+ * - politique : Sort du dictionnaire plein (voir enum PolitiqueLZW).
+ * - taille_bloc : Reçoit la taille totale du bloc produit (en-tête compris).
+ * Retourne : Le bloc alloué (en-tête, paramètres puis codes), à libérer avec memoire_liberer,
+ *            NULL si l'allocation échoue ou si les paramètres sont invalides.
  */
-int compresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom) {
-    unsigned char code_base, caractere_lu; // Variables pour stocker le code de base et le caractère lu
-    int index; // Variable pour stocker l'index de la table
-    long int compte_entrees = 0L, compte_sorties = 0L; // Compteurs pour les entrées et sorties
+unsigned char *compresser_bloc_lzw_avec(const unsigned char *entree, uint32_t taille, int largeur_max, int politique,
+                                        size_t *taille_bloc) {
+    if (largeur_max < LZW_LARGEUR_MIN || largeur_max > LZW_LARGEUR_MAX || politique < LZW_GEL || politique > LZW_ADAPTATIVE) {
+        fprintf(stderr, "Paramètres LZW invalides : codes de %d bits, politique %d\n", largeur_max, politique);
+        return NULL;
+    }
+
+    struct EnTeteBloc en_tete;
+    struct ParametresLZW3 parametres = { (uint8_t)largeur_max, (uint8_t)politique, 0 };
+    // Au pire un code de 16 bits par octet lu, plus les codes de remise à zéro
+    unsigned char *bloc = memoire_allouer(sizeof(en_tete) + LZW_TAILLE_COMPRESSEE(taille));
+    struct DictionnaireLZW dico; // Dictionnaire local : plusieurs blocs peuvent être compressés en parallèle
+    if (creer_dictionnaire(&dico, largeur_max) != 0 || !bloc) {
+        fprintf(stderr, "Mémoire insuffisante\n");
+        memoire_liberer(bloc);
+        liberer_dictionnaire(&dico);
+        return NULL;
+    }
+    unsigned char *corps = bloc + sizeof(en_tete);
+    memcpy(corps, &parametres, sizeof(parametres));
+    struct EcrivainBits ecrivain = { corps + sizeof(parametres), 0, 0 };
+    const int limite = 1 << largeur_max;
+
+    uint32_t crc = crc32c_maj(CRC32C_INIT, entree, taille < CRC32C_TRANCHE ? taille : CRC32C_TRANCHE);
+    uint32_t code_base = entree[0]; // Code de la chaîne en cours
+
+    // LZW_ADAPTATIVE : taux (octets lus par bit écrit) depuis la dernière remise à zéro, mesuré
+    // tous les LZW_INTERVALLE_CONTROLE octets une fois le dictionnaire plein ; s'il baisse, les
+    // entrées ne correspondent plus aux données et le dictionnaire est vidé
+    uint32_t debut_entree = 0, prochain_controle = 0;
+    uint64_t debut_sortie = 0, entree_precedente = 0, sortie_precedente = 1;
+
+    // Boucle pour lire les caractères et compresser
+    for (uint32_t i = 1; i < taille; i++) {
+        // Début d'une nouvelle tranche : on la somme avant de la compresser
+        if (i % CRC32C_TRANCHE == 0) {
+            crc = crc32c_maj(crc, entree + i, taille - i < CRC32C_TRANCHE ? taille - i : CRC32C_TRANCHE);
+        }
+        unsigned char caractere_lu = entree[i];
+        int suite = chercher_suite(&dico, code_base, caractere_lu);
+        if (suite >= 0) {
+            code_base = (uint32_t)suite; // La chaîne prolongée est connue
+            continue;
+        }
+
+        ecrire_code(&ecrivain, code_base, largeur_code(dico.prochain)); // Écrire le code de la chaîne
+        int vider = 0;
+        if (dico.prochain < limite) {
+            if (ajouter_suite(&dico, code_base, caractere_lu) != 0) { // Ajouter la chaîne prolongée au dictionnaire
+                fprintf(stderr, "Mémoire insuffisante\n");
+                memoire_liberer(bloc);
+                liberer_dictionnaire(&dico);
+                return NULL;
+            }
+            vider = dico.prochain == limite && politique == LZW_RAZ;
+            prochain_controle = i + LZW_INTERVALLE_CONTROLE;
+        } else if (politique == LZW_ADAPTATIVE && i >= prochain_controle) {
+            uint64_t lus = i - debut_entree;
+            uint64_t ecrits = (uint64_t)(ecrivain.sortie - corps) * 8 + ecrivain.bits - debut_sortie;
+            vider = lus * sortie_precedente < entree_precedente * ecrits; // Le taux a baissé
+            entree_precedente = lus;
+            sortie_precedente = ecrits;
+            prochain_controle = i + LZW_INTERVALLE_CONTROLE;
+        }
+        if (vider) {
+            ecrire_code(&ecrivain, LZW_CODE_RAZ, largeur_code(dico.prochain));
+            vider_dictionnaire(&dico);
+            debut_entree = i;
+            debut_sortie = (uint64_t)(ecrivain.sortie - corps) * 8 + ecrivain.bits;
+            entree_precedente = 0;
+            sortie_precedente = 1;
+        }
+        code_base = caractere_lu; // Nouvelle chaîne, à partir du caractère lu
+    }
+    ecrire_code(&ecrivain, code_base, largeur_code(dico.prochain)); // Écrire le dernier code
+    if (ecrivain.bits > 0) {
+        ecrire_code(&ecrivain, 0, 8 - ecrivain.bits); // Compléter le dernier octet par des zéros
+    }
+    liberer_dictionnaire(&dico);
+
+    en_tete.taille_originale = taille;
+    en_tete.taille_compressee = (uint32_t)(ecrivain.sortie - corps);
+    en_tete.crc_donnees = crc;
+    en_tete.crc_bloc = calculer_crc_bloc(&en_tete, corps);
+    memcpy(bloc, &en_tete, sizeof(en_tete));
+
+    *taille_bloc = sizeof(en_tete) + en_tete.taille_compressee;
+    return bloc;
+}
+
+
+/**
+ * Fonction : compresser_bloc_lzw
+ * Description : Compresse un bloc avec les réglages par défaut (codes d'au plus LZW_LARGEUR bits,
+ *               politique LZW_ADAPTATIVE, ceux du niveau LZW_NIVEAU), voir compresser_bloc_lzw_avec.
+ */
+unsigned char *compresser_bloc_lzw(const unsigned char *entree, uint32_t taille, size_t *taille_bloc) {
+    return compresser_bloc_lzw_avec(entree, taille, LZW_LARGEUR, LZW_ADAPTATIVE, taille_bloc);
+}
+
+
+/**
+ * Fonction : decompresser_bloc_lzw2
+ * Description : Décompresse un bloc LZW2 (codes de 8 bits) lu par lire_bloc. Le CRC32C des octets produits est calculé
+ *               par tranches au fil du décodage puis comparé à celui de l'en-tête.
+ *               Le bloc n'est pas supposé fiable : chaque code doit désigner une entrée déjà
+ *               définie (ou la suivante, cas KwKwK) et la sortie ne dépasse jamais taille_originale.
+ *               Chaque code produisant au moins un octet, le travail est borné par la taille du bloc.
+ * Paramètres :
+ * - en_tete : En-tête du bloc (tailles déjà bornées par lire_bloc).
+ * - codes : Les en_tete->taille_compressee codes du bloc.
+ * - sortie : Tampon d'au moins en_tete->taille_originale octets.
+ * Retourne : 0 en cas de succès, -1 si le bloc est malformé ou si les données ne correspondent pas au CRC.
+ */
+static int decompresser_bloc_lzw2(const struct EnTeteBloc *en_tete, const unsigned char *codes, unsigned char *sortie) {
+    unsigned char code, dernier_code; // Variables pour stocker les codes
+    int dernier_caractere; // Premier caractère de la dernière chaîne extraite, -1 en cas d'erreur
+    int prochain_code = 128; // Prochain code à ajouter à la table
+    unsigned char *position = sortie, *deja_somme = sortie;
+    const unsigned char *fin = sortie + en_tete->taille_originale;
+    uint32_t crc = CRC32C_INIT;
+    struct TableLZW table; // Table locale : plusieurs blocs peuvent être décompressés en parallèle
+
+    initialiser_table(&table); // Initialiser une table propre à ce bloc
+    code = codes[0]; // Lire le premier code
+    if (code > 127 || en_tete->taille_originale == 0) {
+        fprintf(stderr, "Bloc malformé : premier code invalide\n");
+        return -1;
+    }
+    *position++ = code; // Écrire le premier code dans le tampon de sortie
+    dernier_code = code; // Stocker le dernier code
+
+    // Boucle pour lire les codes et décompresser
+    for (uint32_t i = 1; i < en_tete->taille_compressee; i++) {
+        code = codes[i];
+        if (code > prochain_code) {
+            fprintf(stderr, "Bloc malformé : code %u non défini\n", code);
+            return -1;
+        }
+        if (code == prochain_code) {
+            dernier_caractere = extraire_chaine(&table, dernier_code, &position, fin); // Extraire la chaîne du dernier code
+            if (dernier_caractere >= 0 && position < fin) {
+                *position++ = (unsigned char)dernier_caractere; // Écrire le caractère dans le tampon de sortie
+            } else {
+                dernier_caractere = -1;
+            }
+        } else {
+            dernier_caractere = extraire_chaine(&table, code, &position, fin); // Extraire la chaîne du code actuel
+        }
+        if (dernier_caractere < 0) {
+            fprintf(stderr, "Bloc malformé : données décodées plus longues qu'annoncé\n");
+            return -1;
+        }
+        // Ajouter le nouveau code à la table si elle n'est pas pleine
+        if (table.table_complete) {
+            ajouter_code(&table, (unsigned char)dernier_caractere, dernier_code, prochain_code); // Ajouter le code à la table
+            prochain_code++; // Incrémenter le prochain code
+            if (prochain_code > 255) {
+                table.table_complete = 0; // La table est pleine
+            }
+        }
+        dernier_code = code; // Mettre à jour le dernier code
+
+        // CRC de la tranche qui vient d'être produite, encore dans le cache
+        if (position - deja_somme >= CRC32C_TRANCHE) {
+            crc = crc32c_maj(crc, deja_somme, position - deja_somme);
+            deja_somme = position;
+        }
+    }
+    crc = crc32c_maj(crc, deja_somme, position - deja_somme);
+
+    if (position != fin) {
+        fprintf(stderr, "Bloc malformé : données décodées plus courtes qu'annoncé\n");
+        return -1;
+    }
+    if (crc != en_tete->crc_donnees) {
+        fprintf(stderr, "Données corrompues : CRC32C des données incorrect\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+/* Entrée du dictionnaire du décompresseur : la chaîne est son préfixe suivi de caractere */
+struct EntreeLZW3 {
+    uint16_t prefixe;
+    uint16_t longueur;  // Longueur de la chaîne (moins de 2^16 : chaque entrée prolonge une plus ancienne)
+    unsigned char caractere;
+    unsigned char premier;  // Premier octet de la chaîne
+};
+
+// Lecture d'un code de largeur bits à la position pos (en bits), -1 au-delà de la fin des codes
+static inline int32_t lire_code(const unsigned char *codes, uint64_t taille, uint64_t *pos, int largeur) {
+    if (*pos + largeur > taille * 8) {
+        return -1;
+    }
+    uint64_t octet = *pos >> 3;
+    uint32_t fenetre = (uint32_t)codes[octet] << 16;
+    if (octet + 1 < taille) {
+        fenetre |= (uint32_t)codes[octet + 1] << 8;
+    }
+    if (octet + 2 < taille) {
+        fenetre |= codes[octet + 2];
+    }
+    int32_t code = (int32_t)((fenetre << (*pos & 7) & 0xFFFFFF) >> (24 - largeur));
+    *pos += largeur;
+    return code;
+}
+
+// Écrit la chaîne d'une entrée à partir de sortie (la place est déjà vérifiée)
+static inline void ecrire_chaine(const struct EntreeLZW3 *dico, uint32_t code, unsigned char *sortie) {
+    for (uint32_t i = dico[code].longueur; i-- > 0;) {
+        sortie[i] = dico[code].caractere;
+        code = dico[code].prefixe;
+    }
+}
+
+
+/**
+ * Fonction : decompresser_bloc_lzw
+ * Description : Décompresse un bloc LZW3 lu par lire_bloc. Le CRC32C des octets produits est
+ *               calculé par tranches au fil du décodage puis comparé à celui de l'en-tête.
+ *               Le bloc n'est pas supposé fiable : les paramètres sont validés, chaque code doit
+ *               désigner une entrée déjà définie (ou la suivante, cas KwKwK), la sortie ne dépasse
+ *               jamais taille_originale et tous les codes doivent être consommés.
+ * Paramètres :
+ * - en_tete : En-tête du bloc (tailles déjà bornées par lire_bloc).
+ * - corps : Les en_tete->taille_compressee octets du bloc (paramètres puis codes).
+ * - sortie : Tampon d'au moins en_tete->taille_originale octets.
+ * Retourne : 0 en cas de succès, -1 si le bloc est malformé ou si les données ne correspondent pas au CRC.
+ */
+int decompresser_bloc_lzw(const struct EnTeteBloc *en_tete, const unsigned char *corps, unsigned char *sortie) {
+    struct ParametresLZW3 parametres;
+    if (en_tete->taille_compressee < sizeof(parametres) || en_tete->taille_originale == 0) {
+        fprintf(stderr, "Bloc malformé : bloc LZW3 vide\n");
+        return -1;
+    }
+    memcpy(&parametres, corps, sizeof(parametres));
+    if (parametres.largeur_max < LZW_LARGEUR_MIN || parametres.largeur_max > LZW_LARGEUR_MAX ||
+        parametres.politique > LZW_ADAPTATIVE || parametres.reserve != 0) {
+        fprintf(stderr, "Bloc malformé : paramètres LZW3 invalides\n");
+        return -1;
+    }
+    const unsigned char *codes = corps + sizeof(parametres);
+    const uint64_t taille_codes = en_tete->taille_compressee - sizeof(parametres);
+    const int limite = 1 << parametres.largeur_max;
+
+    // Dictionnaire local : plusieurs blocs peuvent être décompressés en parallèle
+    struct EntreeLZW3 *dico = memoire_allouer((size_t)limite * sizeof(*dico));
+    if (!dico) {
+        fprintf(stderr, "Mémoire insuffisante\n");
+        return -1;
+    }
+    for (int i = 0; i < 256; i++) {
+        dico[i] = (struct EntreeLZW3){ 0, 1, (unsigned char)i, (unsigned char)i };
+    }
+
+    unsigned char *position = sortie, *deja_somme = sortie;
+    const unsigned char *fin = sortie + en_tete->taille_originale;
+    uint32_t crc = CRC32C_INIT;
+    uint64_t pos = 0;
+    int nb_entrees = LZW_PREMIER_CODE; // Entrées définies
+    int32_t dernier_code = -1; // Code précédent, -1 au début et après une remise à zéro
+    const char *erreur = NULL;
+
+    while (position < fin) {
+        // Le compresseur a une entrée d'avance : celle que ce code va compléter
+        int entrees_compresseur = dernier_code < 0 || nb_entrees == limite ? nb_entrees : nb_entrees + 1;
+        int32_t code = lire_code(codes, taille_codes, &pos, largeur_code(entrees_compresseur));
+        if (code < 0) {
+            erreur = "codes tronqués";
+            break;
+        }
+        if (code == LZW_CODE_RAZ) {
+            if (parametres.politique == LZW_GEL || entrees_compresseur != limite) {
+                erreur = "remise à zéro inattendue";
+                break;
+            }
+            nb_entrees = LZW_PREMIER_CODE;
+            dernier_code = -1;
+            continue;
+        }
+        if (code > nb_entrees || (code == nb_entrees && (dernier_code < 0 || nb_entrees == limite))) {
+            erreur = "code non défini";
+            break;
+        }
+
+        // Chaîne du code, ou pour KwKwK la chaîne précédente suivie de son premier octet
+        uint32_t longueur = code < nb_entrees ? dico[code].longueur : dico[dernier_code].longueur + 1u;
+        if ((uint32_t)(fin - position) < longueur) {
+            erreur = "données décodées plus longues qu'annoncé";
+            break;
+        }
+        if (code < nb_entrees) {
+            ecrire_chaine(dico, (uint32_t)code, position);
+        } else {
+            ecrire_chaine(dico, (uint32_t)dernier_code, position);
+            position[longueur - 1] = dico[dernier_code].premier;
+        }
+
+        // Entrée laissée en attente par le code précédent : cette chaîne en donne le dernier octet
+        if (dernier_code >= 0 && nb_entrees < limite) {
+            dico[nb_entrees].prefixe = (uint16_t)dernier_code;
+            dico[nb_entrees].longueur = (uint16_t)(dico[dernier_code].longueur + 1);
+            dico[nb_entrees].caractere = position[0];
+            dico[nb_entrees].premier = dico[dernier_code].premier;
+            nb_entrees++;
+        }
+        position += longueur;
+        dernier_code = code;
+
+        // CRC de la tranche qui vient d'être produite, encore dans le cache
+        if (position - deja_somme >= CRC32C_TRANCHE) {
+            crc = crc32c_maj(crc, deja_somme, position - deja_somme);
+            deja_somme = position;
+        }
+    }
+    memoire_liberer(dico);
+
+    if (erreur) {
+        fprintf(stderr, "Bloc malformé : %s\n", erreur);
+        return -1;
+    }
+    if ((pos + 7) / 8 != taille_codes) {
+        fprintf(stderr, "Bloc malformé : codes en trop\n");
+        return -1;
+    }
+    crc = crc32c_maj(crc, deja_somme, position - deja_somme);
+    if (crc != en_tete->crc_donnees) {
+        fprintf(stderr, "Données corrompues : CRC32C des données incorrect\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+/* Réglages de chaque niveau, du plus rapide (1) au plus compact (9) : les petits dictionnaires
+ * restent dans le cache L1 et sont vidés dès qu'ils sont pleins ; au-delà de 4096 entrées, le
+ * dictionnaire plein est gardé tant que le taux de compression ne baisse pas */
+static const struct {
+    int largeur_max;
+    int politique;
+} niveaux_lzw[9] = {
+    { 9, LZW_RAZ },
+    { 10, LZW_RAZ },
+    { 11, LZW_RAZ },
+    { 12, LZW_RAZ },
+    { 12, LZW_ADAPTATIVE },
+    { 13, LZW_ADAPTATIVE },
+    { 14, LZW_ADAPTATIVE },
+    { 15, LZW_ADAPTATIVE },
+    { 16, LZW_ADAPTATIVE },
+};
+
+/**
+ * Fonction : options_niveau_lzw
+ * Description : Remplit les options de compression d'un niveau (1 à 9, bornés), pour tous les cœurs.
+ * Paramètres :
+ * - niveau : Niveau demandé, LZW_NIVEAU par défaut.
+ * - options : Options à remplir.
+ */
+void options_niveau_lzw(int niveau, struct OptionsLZW *options) {
+    niveau = niveau < 1 ? 1 : niveau > 9 ? 9 : niveau;
+    options->taille_bloc = LZW_TAILLE_BLOC;
+    options->largeur_max = niveaux_lzw[niveau - 1].largeur_max;
+    options->politique = niveaux_lzw[niveau - 1].politique;
+    options->nb_threads = 0;
+    options->profondeur = 0;
+}
+
+
+/**
+ * Fonction : options_econome_lzw
+ * Description : Remplit les options du mode économe en mémoire, pour les petites cibles : blocs de
+ *               LZW_ECONOME_TAILLE_BLOC octets, dictionnaire de 4096 entrées au plus, un seul
+ *               travailleur et deux blocs en mémoire. La mémoire de travail est alors bornée par
+ *               borne_memoire_compression_lzw et borne_memoire_decompression_lzw (moins de 800 Ko).
+ * Paramètres :
+ * - options : Options à remplir, valables pour la compression comme pour la décompression.
+ */
+void options_econome_lzw(struct OptionsLZW *options) {
+    options->taille_bloc = LZW_ECONOME_TAILLE_BLOC;
+    options->largeur_max = 12;
+    options->politique = LZW_ADAPTATIVE;
+    options->nb_threads = 1;
+    options->profondeur = 2;
+}
+
+
+/**
+ * Fonction : compresser_flux_lzw
+ * Description : Compresse un flux déjà ouvert vers un autre flux, au format LZW3 : le nombre
+ *               magique puis des blocs de LZW_TAILLE_BLOC octets au plus, chacun protégé par
+ *               deux CRC32C, et un en-tête vide pour marquer la fin. Réglages par défaut.
+ * Paramètres :
+ * - fichier_entree : Flux à compresser.
+ * - fichier_sortie : Flux où la compression est écrite.
+ * - compte_entrees : Reçoit le nombre d'octets lus.
+ * - compte_sorties : Reçoit le nombre d'octets compressés écrits (hors en-têtes).
+ * Retourne : 0 en cas de succès, -1 si la mémoire manque.
+ */
+int compresser_flux_lzw(FILE *fichier_entree, FILE *fichier_sortie, long int *compte_entrees, long int *compte_sorties) {
+    *compte_entrees = *compte_sorties = 0L; // Compteurs pour les entrées et sorties
+
+    unsigned char *entree = memoire_allouer(LZW_TAILLE_BLOC);
+    if (!entree) {
+        fprintf(stderr, "Mémoire insuffisante\n");
+        return -1;
+    }
+
+    fwrite(LZW_MAGIQUE, 1, TAILLE_MAGIQUE, fichier_sortie);
+
+    // Boucle pour lire et compresser les blocs
+    size_t lus;
+    while ((lus = fread(entree, 1, LZW_TAILLE_BLOC, fichier_entree)) > 0) {
+        size_t taille_bloc;
+        unsigned char *bloc = compresser_bloc_lzw(entree, (uint32_t)lus, &taille_bloc);
+        if (!bloc) {
+            memoire_liberer(entree);
+            return -1;
+        }
+        fwrite(bloc, 1, taille_bloc, fichier_sortie);
+        *compte_entrees += lus; // Incrémenter le compteur d'entrées
+        *compte_sorties += taille_bloc - sizeof(struct EnTeteBloc); // Incrémenter le compteur de sorties
+        memoire_liberer(bloc);
+    }
+
+    // Marqueur de fin
+    struct EnTeteBloc fin = {0};
+    fwrite(&fin, sizeof(fin), 1, fichier_sortie);
+
+    memoire_liberer(entree);
+    return 0;
+}
+
+
+/* Décodeur de bloc selon le nombre magique ; la taille compressée d'un bloc est bornée par
+ * LZW_TAILLE_COMPRESSEE en LZW3, par sa taille d'origine en LZW2 (un code, un octet au moins) */
+struct DecodeurLZW {
+    int (*decompresser)(const struct EnTeteBloc *en_tete, const unsigned char *corps, unsigned char *sortie);
+    int largeur_variable;
+};
+static const struct DecodeurLZW decodeur_lzw3 = { decompresser_bloc_lzw, 1 };
+static const struct DecodeurLZW decodeur_lzw2 = { decompresser_bloc_lzw2, 0 };
+
+// Plus grand corps d'un bloc d'au plus taille_bloc octets avant compression
+static uint32_t taille_compressee_max(const struct DecodeurLZW *decodeur, uint32_t taille_bloc) {
+    return decodeur->largeur_variable ? (uint32_t)LZW_TAILLE_COMPRESSEE(taille_bloc) : taille_bloc;
+}
+
+// Décodeur correspondant à un nombre magique, NULL s'il n'est pas reconnu
+static const struct DecodeurLZW *decodeur_pour(const char magique[TAILLE_MAGIQUE]) {
+    if (memcmp(magique, LZW_MAGIQUE, TAILLE_MAGIQUE) == 0) {
+        return &decodeur_lzw3;
+    }
+    if (memcmp(magique, LZW_MAGIQUE_V2, TAILLE_MAGIQUE) == 0) {
+        return &decodeur_lzw2;
+    }
+    return NULL;
+}
+
+// Décodeur correspondant au nombre magique d'un fichier ouvert, NULL pour l'ancien format
+static const struct DecodeurLZW *decodeur_du_fichier(int fichier) {
+    char magique[TAILLE_MAGIQUE];
+    if (pread(fichier, magique, TAILLE_MAGIQUE, 0) != TAILLE_MAGIQUE) {
+        return NULL;
+    }
+    return decodeur_pour(magique);
+}
+
+
+/**
+ * Fonction : decompresser_ancien_flux_lzw
+ * Description : Décompresse un flux de l'ancien format, sans nombre magique ni blocs : des codes de
+ *               8 bits jusqu'à la fin du flux, décodés avec la table de decompresser_bloc_lzw2.
+ *               Ce format n'a pas de CRC : seuls les codes non définis sont détectés.
+ * Paramètres :
+ * - fichier_entree : Flux compressé, positionné au début.
+ * - fichier_sortie : Flux de sortie.
+ * - total_codes : Reçoit le nombre de codes traités (peut être NULL).
+ * Retourne : 0 en cas de succès, -1 si le flux est vide ou malformé.
+ */
+static int decompresser_ancien_flux_lzw(FILE *fichier_entree, FILE *fichier_sortie, long *total_codes) {
+    // La sortie est vidée dès qu'elle dépasse LZW_TAMPON_ANCIEN octets : un code en ajoute au plus
+    // LZW_LONGUEUR_MAX + 1
+    unsigned char *codes = memoire_allouer(LZW_TAMPON_ANCIEN);
+    unsigned char *sortie = memoire_allouer(LZW_TAMPON_ANCIEN + LZW_LONGUEUR_MAX + 1);
+    const unsigned char *fin = sortie + LZW_TAMPON_ANCIEN + LZW_LONGUEUR_MAX + 1;
+    unsigned char *position = sortie;
+    struct TableLZW table;
+    int prochain_code = 128; // Prochain code à ajouter à la table
+    int dernier_code = -1;   // Aucun code lu
+    long codes_traites = 0;
+    int resultat = codes && sortie ? 0 : -1;
+    size_t lus;
+
+    if (resultat != 0) {
+        fprintf(stderr, "Mémoire insuffisante\n");
+    }
+    initialiser_table(&table);
+    while (resultat == 0 && (lus = fread(codes, 1, LZW_TAMPON_ANCIEN, fichier_entree)) > 0) {
+        for (size_t i = 0; i < lus && resultat == 0; i++) {
+            unsigned char code = codes[i];
+            int dernier_caractere; // Premier caractère de la dernière chaîne extraite, -1 en cas d'erreur
+            if (dernier_code < 0) {
+                // Premier code : un caractère de base
+                if (code > 127) {
+                    fprintf(stderr, "Flux malformé : premier code invalide\n");
+                    resultat = -1;
+                    break;
+                }
+                *position++ = code;
+                dernier_code = code;
+                continue;
+            }
+            if (code > prochain_code) {
+                fprintf(stderr, "Flux malformé : code %u non défini\n", code);
+                resultat = -1;
+                break;
+            }
+            if (code == prochain_code) {
+                dernier_caractere = extraire_chaine(&table, (unsigned char)dernier_code, &position, fin);
+                if (dernier_caractere >= 0 && position < fin) {
+                    *position++ = (unsigned char)dernier_caractere;
+                } else {
+                    dernier_caractere = -1;
+                }
+            } else {
+                dernier_caractere = extraire_chaine(&table, code, &position, fin);
+            }
+            if (dernier_caractere < 0) {
+                fprintf(stderr, "Flux malformé : chaîne trop longue\n");
+                resultat = -1;
+                break;
+            }
+            // Ajouter le nouveau code à la table si elle n'est pas pleine
+            if (table.table_complete) {
+                ajouter_code(&table, (unsigned char)dernier_caractere, (unsigned char)dernier_code, prochain_code);
+                prochain_code++;
+                if (prochain_code > 255) {
+                    table.table_complete = 0; // La table est pleine
+                }
+            }
+            dernier_code = code;
+
+            if (position - sortie >= LZW_TAMPON_ANCIEN) {
+                fwrite(sortie, 1, position - sortie, fichier_sortie);
+                position = sortie;
+            }
+        }
+        codes_traites += (long)lus;
+    }
+    if (resultat == 0 && dernier_code < 0) {
+        fprintf(stderr, "Flux vide\n");
+        resultat = -1;
+    }
+    if (resultat == 0) {
+        fwrite(sortie, 1, position - sortie, fichier_sortie);
+        if (ferror(fichier_entree) || ferror(fichier_sortie)) {
+            perror("Erreur de lecture ou d'écriture");
+            resultat = -1;
+        }
+    }
+
+    memoire_liberer(sortie);
+    memoire_liberer(codes);
+    if (resultat == 0 && total_codes) {
+        *total_codes = codes_traites;
+    }
+    return resultat;
+}
+
+
+/**
+ * Fonction : decompresser_flux_lzw
+ * Description : Décompresse un flux LZW3 ou LZW2 déjà ouvert vers un autre flux. Chaque bloc est
+ *               vérifié (CRC du bloc avant décodage, CRC des données après) avant d'être écrit.
+ *               Un flux sans nombre magique est lu dans l'ancien format (voir decompresser_ancien_flux_lzw).
+ * Paramètres :
+ * - fichier_entree : Flux compressé, positionné au début.
+ * - fichier_sortie : Flux de sortie.
+ * - total_codes : Reçoit le nombre d'octets compressés traités, hors en-têtes (peut être NULL).
+ * Retourne : 0 en cas de succès, -1 si le flux est malformé, corrompu ou tronqué.
+ */
+int decompresser_flux_lzw(FILE *fichier_entree, FILE *fichier_sortie, long *total_codes) {
+    char magique[TAILLE_MAGIQUE];
+    const struct DecodeurLZW *decodeur = NULL;
+    size_t magique_lue = fread(magique, 1, TAILLE_MAGIQUE, fichier_entree);
+    if (magique_lue == TAILLE_MAGIQUE) {
+        decodeur = decodeur_pour(magique);
+    }
+    if (!decodeur) {
+        // Ancien format : les octets lus sont les premiers codes
+        if (fseek(fichier_entree, -(long)magique_lue, SEEK_CUR) != 0) {
+            perror("Le flux n'est pas au format LZW3 ni LZW2 et ne peut pas être relu");
+            return -1;
+        }
+        return decompresser_ancien_flux_lzw(fichier_entree, fichier_sortie, total_codes);
+    }
+
+    struct EnTeteBloc en_tete;
+    unsigned char *codes = NULL;
+    size_t capacite = 0;
+    unsigned char *sortie = memoire_allouer(LZW_TAILLE_BLOC);
+    long codes_traites = 0; // Compteur pour les codes traités
+    int nb_blocs = 0;
+    int resultat;
+
+    // Boucle pour lire les blocs et décompresser
+    while ((resultat = lire_bloc(fichier_entree, &en_tete, &codes, &capacite,
+                                 LZW_TAILLE_BLOC, taille_compressee_max(decodeur, LZW_TAILLE_BLOC))) == 1) {
+        if (!sortie || decodeur->decompresser(&en_tete, codes, sortie) != 0) {
+            resultat = -1;
+            break;
+        }
+        fwrite(sortie, 1, en_tete.taille_originale, fichier_sortie);
+        codes_traites += en_tete.taille_compressee; // Incrémenter le compteur de codes traités
+        nb_blocs++;
+    }
+
+    memoire_liberer(sortie);
+    memoire_liberer(codes);
+
+    if (resultat < 0) {
+        fprintf(stderr, "Échec de la décompression au bloc %d\n", nb_blocs + 1);
+        return -1;
+    }
+    if (total_codes) {
+        *total_codes = codes_traites;
+    }
+    return 0;
+}
+
+
+// Options de fichier valides : taille de bloc et largeur des codes dans les limites du format
+static int verifier_options_lzw(const struct OptionsLZW *options) {
+    if (options->taille_bloc == 0 || options->taille_bloc > LZW_TAILLE_BLOC) {
+        fprintf(stderr, "Taille de bloc LZW invalide : %u octets (au plus %d)\n", options->taille_bloc, LZW_TAILLE_BLOC);
+        return -1;
+    }
+    if (options->largeur_max < LZW_LARGEUR_MIN || options->largeur_max > LZW_LARGEUR_MAX) {
+        fprintf(stderr, "Largeur de code LZW invalide : %d bits\n", options->largeur_max);
+        return -1;
+    }
+    return 0;
+}
+
+// Paramètres du pipeline de compression (sans le traitement)
+static void parametres_compression(const struct OptionsLZW *options, struct ParametresPipeline *parametres) {
+    *parametres = (struct ParametresPipeline){0};
+    parametres->decoupage = DECOUPAGE_TRANCHES;
+    parametres->taille_tranche = options->taille_bloc;
+    parametres->nb_travailleurs = options->nb_threads;
+    parametres->profondeur = options->profondeur;
+}
+
+/**
+ * Fonction : borne_memoire_compression_lzw
+ * Description : Borne la mémoire de travail de compresser_fichier_lzw avec ces options (telle que
+ *               mesurée dans StatistiquesPipeline.memoire_pic) : le pipeline, ses blocs et leur
+ *               sortie au pire, plus un dictionnaire plein par travailleur.
+ * Paramètres :
+ * - options : Options de compression.
+ * Retourne : La borne, en octets.
+ */
+size_t borne_memoire_compression_lzw(const struct OptionsLZW *options) {
+    struct ParametresPipeline parametres;
+    parametres_compression(options, &parametres);
+    return borne_memoire_pipeline(&parametres, sizeof(struct EnTeteBloc) + LZW_TAILLE_COMPRESSEE(options->taille_bloc),
+                                  borne_dictionnaire(options->largeur_max));
+}
+
+
+// Traitement d'une tranche par un travailleur du pipeline, avec les options du fichier
+static unsigned char *tache_compression(const unsigned char *entree, size_t taille, size_t *taille_sortie, void *contexte) {
+    const struct OptionsLZW *options = contexte;
+    return compresser_bloc_lzw_avec(entree, (uint32_t)taille, options->largeur_max, options->politique, taille_sortie);
+}
+
+
+/**
+ * Fonction : compresser_fichier_lzw
+ * Description : Compresse un fichier au format LZW3 avec les options données. La lecture, la
+ *               compression des blocs et l'écriture se recouvrent (voir executer_pipeline).
+ * Paramètres :
+ * - fichier_entree_nom : Nom du fichier d'entrée à compresser, éventuellement un tube (lu dans l'ordre).
+ * - fichier_sortie_nom : Nom du fichier de sortie où la compression est écrite (pas un tube).
+ * - options : Taille des blocs (au plus LZW_TAILLE_BLOC), largeur des codes, politique, nombre
+ *             de travailleurs et profondeur du pipeline (voir options_niveau_lzw et options_econome_lzw).
+ * - stats : Reçoit les mesures du pipeline (peut être NULL).
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur (message déjà affiché).
+ */
+int compresser_fichier_lzw(const char *fichier_entree_nom, const char *fichier_sortie_nom,
+                           const struct OptionsLZW *options, struct StatistiquesPipeline *stats) {
+    if (verifier_options_lzw(options) != 0) {
+        return -1;
+    }
 
     // Ouverture du fichier d'entrée
-    fichier_entree = fopen(fichier_entree_nom, "r");
-    if (!fichier_entree) {
+    int fichier_entree = open(fichier_entree_nom, O_RDONLY);
+    if (fichier_entree < 0) {
         fprintf(stderr, "Erreur lors de l'ouverture du fichier %s\n", fichier_entree_nom); // Message d'erreur
-        exit(EXIT_FAILURE); // Sortie en cas d'erreur
+        return -1;
     }
 
     // Ouverture du fichier de sortie
-    fichier_sortie = fopen(fichier_sortie_nom, "w+");
-    if (!fichier_sortie) {
+    int fichier_sortie = open(fichier_sortie_nom, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fichier_sortie < 0) {
         fprintf(stderr, "Erreur lors de l'ouverture du fichier %s\n", fichier_sortie_nom); // Message d'erreur
-        fclose(fichier_entree); // Fermer le fichier d'entrée
-        exit(EXIT_FAILURE); // Sortie en cas d'erreur
+        close(fichier_entree); // Fermer le fichier d'entrée
+        return -1;
     }
 
-    initialiser_table(); // Initialiser la table LZW
-    LIRE_CHAR(code_base); // Lire le premier caractère
-    compte_entrees++; // Incrémenter le compteur d'entrées
+    // Nombre magique, blocs écrits par le pipeline, puis marqueur de fin
+    struct ParametresPipeline parametres;
+    parametres_compression(options, &parametres);
+    parametres.traitement = tache_compression;
+    parametres.contexte = (void *)options;
+    struct StatistiquesPipeline mesures;
+    struct EnTeteBloc fin = {0};
 
-    // Boucle pour lire les caractères et compresser
-    while (LIRE_CHAR(caractere_lu)) {
-        compte_entrees++; // Incrémenter le compteur d'entrées
-        if (rechercher_entree(caractere_lu, code_base, &index)) {
-            code_base = (unsigned char)index; // Mettre à jour le code de base
+    int resultat = -1;
+    if (pwrite(fichier_sortie, LZW_MAGIQUE, TAILLE_MAGIQUE, 0) != TAILLE_MAGIQUE) {
+        perror("Erreur d'écriture");
+    } else if (executer_pipeline(fichier_entree, 0, fichier_sortie, TAILLE_MAGIQUE, &parametres, &mesures) == 0) {
+        if (pwrite(fichier_sortie, &fin, sizeof(fin), TAILLE_MAGIQUE + mesures.octets_ecrits) != sizeof(fin)) {
+            perror("Erreur d'écriture");
         } else {
-            ECRIRE_CHAR(code_base); // Écrire le code de base dans le fichier de sortie
-            compte_sorties++; // Incrémenter le compteur de sorties
-            if (table_complete) {
-                ajouter_code(caractere_lu, code_base, index); // Ajouter le code à la table
-            }
-            code_base = caractere_lu; // Mettre à jour le code de base avec le caractère lu
+            resultat = 0;
         }
     }
-    ECRIRE_CHAR(code_base); // Écrire le dernier code de base
-    compte_sorties++; // Incrémenter le compteur de sorties
 
     // Fermer les fichiers
-    fclose(fichier_sortie);
-    fclose(fichier_entree);
+    close(fichier_sortie);
+    close(fichier_entree);
+
+    if (resultat != 0) {
+        fprintf(stderr, "Échec de la compression de %s\n", fichier_entree_nom);
+    } else if (stats) {
+        *stats = mesures;
+    }
+    return resultat;
+}
+
+
+/**
+ * Fonction : compresser_lzw
+ * Description : Compresse un fichier avec l'algorithme LZW, au niveau par défaut (voir compresser_fichier_lzw).
+ * Paramètres :
+ * - fichier_entree_nom : Nom du fichier d'entrée à compresser.
+ * - fichier_sortie_nom : Nom du fichier de sortie où la compression est écrite.
+ * Retourne : Le taux de compression en pourcentage.
+ */
+int compresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom) {
+    long int compte_entrees, compte_sorties; // Compteurs pour les entrées et sorties
+    struct OptionsLZW options;
+    struct StatistiquesPipeline stats;
+
+    options_niveau_lzw(LZW_NIVEAU, &options);
+    if (compresser_fichier_lzw(fichier_entree_nom, fichier_sortie_nom, &options, &stats) != 0) {
+        exit(EXIT_FAILURE); // Sortie en cas d'erreur
+    }
+
+    compte_entrees = (long)stats.octets_lus;
+    compte_sorties = (long)(stats.octets_ecrits - stats.nb_blocs * sizeof(struct EnTeteBloc)); // Codes seuls
+    if (compte_entrees == 0) {
+        compte_entrees = 1; // Fichier vide : évite la division par zéro
+    }
 
     // Résumé de la compression
     printf("Résumé de la compression :\n");
     printf("Total d'entrées : %ld\n", compte_entrees); // Afficher le total d'entrées
     printf("Total de sorties : %ld\n", compte_sorties); // Afficher le total de sorties
     printf("Taux de compression : %d%%\n", (int)(((float)compte_sorties / (float)compte_entrees) * 100.0)); // Afficher le taux de compression
+    printf("CRC32C : %s\n", crc32c_implementation());
+    afficher_statistiques_pipeline(&stats);
 
     return (int)(((float)compte_sorties / (float)compte_entrees) * 100.0); // Retourner le taux de compression
 }
 
 
+/* Contexte des travailleurs de décompression : le décodeur du format et la plus grande largeur
+ * de codes admise, qui borne le dictionnaire de chaque bloc */
+struct ContexteDecompressionLZW {
+    const struct DecodeurLZW *decodeur;
+    int largeur_max;
+};
+
+// Paramètres du pipeline de décompression (sans le traitement)
+static void parametres_decompression(const struct OptionsLZW *options, const struct DecodeurLZW *decodeur,
+                                     struct ParametresPipeline *parametres) {
+    *parametres = (struct ParametresPipeline){0};
+    parametres->decoupage = DECOUPAGE_BLOCS;
+    parametres->taille_originale_max = options->taille_bloc;
+    parametres->taille_compressee_max = taille_compressee_max(decodeur, options->taille_bloc);
+    parametres->nb_travailleurs = options->nb_threads;
+    parametres->profondeur = options->profondeur;
+}
+
 /**
- * Fonction : decompresser_lzw
- * Description : Décompresse un fichier avec l'algorithme LZW.
+ * Fonction : borne_memoire_decompression_lzw
+ * Description : Borne la mémoire de travail de decompresser_fichier_lzw avec ces options, quel que
+ *               soit le fichier : les blocs plus grands que options->taille_bloc ou dont les codes
+ *               dépassent options->largeur_max bits sont refusés.
+ * Paramètres :
+ * - options : Options de décompression (la politique n'est pas utilisée).
+ * Retourne : La borne, en octets.
+ */
+size_t borne_memoire_decompression_lzw(const struct OptionsLZW *options) {
+    struct ParametresPipeline parametres;
+    parametres_decompression(options, &decodeur_lzw3, &parametres); // Les blocs LZW2 sont plus petits
+    return borne_memoire_pipeline(&parametres, options->taille_bloc,
+                                  MEMOIRE_SURCOUT + ((size_t)1 << options->largeur_max) * sizeof(struct EntreeLZW3));
+}
+
+// Traitement d'un bloc (en-tête et codes) par un travailleur du pipeline
+static unsigned char *tache_decompression(const unsigned char *bloc, size_t taille, size_t *taille_sortie, void *contexte) {
+    (void)taille;
+    const struct ContexteDecompressionLZW *ctx = contexte;
+    struct EnTeteBloc en_tete;
+    memcpy(&en_tete, bloc, sizeof(en_tete));
+    const unsigned char *codes = bloc + sizeof(en_tete);
+
+    if (calculer_crc_bloc(&en_tete, codes) != en_tete.crc_bloc) {
+        fprintf(stderr, "Bloc corrompu : CRC32C incorrect\n");
+        return NULL;
+    }
+    struct ParametresLZW3 parametres;
+    if (ctx->decodeur->largeur_variable && en_tete.taille_compressee >= sizeof(parametres)) {
+        memcpy(&parametres, codes, sizeof(parametres));
+        if (parametres.largeur_max > ctx->largeur_max) {
+            fprintf(stderr, "Bloc refusé : codes de %u bits, au plus %d admis\n", parametres.largeur_max, ctx->largeur_max);
+            return NULL;
+        }
+    }
+    unsigned char *sortie = memoire_allouer(en_tete.taille_originale);
+    if (!sortie) {
+        fprintf(stderr, "Mémoire insuffisante\n");
+        return NULL;
+    }
+    if (ctx->decodeur->decompresser(&en_tete, codes, sortie) != 0) {
+        memoire_liberer(sortie);
+        return NULL;
+    }
+    *taille_sortie = en_tete.taille_originale;
+    return sortie;
+}
+
+
+/**
+ * Fonction : decompresser_fichier_lzw
+ * Description : Décompresse un fichier LZW3 ou LZW2. Les blocs sont décompressés en parallèle
+ *               et écrits dans l'ordre (voir executer_pipeline). Un fichier sans nombre magique est
+ *               lu dans l'ancien format, séquentiellement (voir decompresser_ancien_flux_lzw).
  * Paramètres :
  * - fichier_entree_nom : Nom du fichier d'entrée à décompresser.
  * - fichier_sortie_nom : Nom du fichier de sortie où la décompression est écrite.
- * Retourne : Aucun.
+ * - options : Nombre de travailleurs (0 pour un par cœur) et profondeur du pipeline ; les blocs de
+ *             plus de taille_bloc octets ou aux codes de plus de largeur_max bits sont refusés.
+ * - stats : Reçoit les mesures du pipeline (peut être NULL) ; pour l'ancien format, seuls les
+ *           octets lus et écrits, la durée et la mémoire sont renseignés.
+ * Retourne : 0 en cas de succès, -1 si un fichier ne peut pas être ouvert, si l'entrée est un tube,
+ *            corrompue ou hors des limites des options.
  */
-void decompresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom) {
-    unsigned char code, dernier_code, dernier_caractere; // Variables pour stocker les codes et caractères
-    int prochain_code = 128; // Prochain code à ajouter à la table
+int decompresser_fichier_lzw(const char *fichier_entree_nom, const char *fichier_sortie_nom,
+                             const struct OptionsLZW *options, struct StatistiquesPipeline *stats) {
+    if (verifier_options_lzw(options) != 0) {
+        return -1;
+    }
 
-    // Ouverture du fichier d'entrée
-    fichier_entree = fopen(fichier_entree_nom, "r");
-    if (!fichier_entree) {
+    // Ouverture du fichier d'entrée, lu par positions (le nombre magique avant les blocs)
+    int fichier_entree = open(fichier_entree_nom, O_RDONLY);
+    if (fichier_entree < 0) {
         fprintf(stderr, "Erreur lors de l'ouverture du fichier %s\n", fichier_entree_nom); // Message d'erreur
-        exit(EXIT_FAILURE); // Sortie en cas d'erreur
+        return -1;
+    }
+    struct stat infos;
+    if (fstat(fichier_entree, &infos) == 0 && (S_ISFIFO(infos.st_mode) || S_ISSOCK(infos.st_mode))) {
+        fprintf(stderr, "%s : un tube ne peut pas être décompressé\n", fichier_entree_nom);
+        close(fichier_entree);
+        return -1;
     }
 
     // Ouverture du fichier de sortie
-    fichier_sortie = fopen(fichier_sortie_nom, "w+");
-    if (!fichier_sortie) {
+    int fichier_sortie = open(fichier_sortie_nom, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fichier_sortie < 0) {
         fprintf(stderr, "Erreur lors de l'ouverture du fichier %s\n", fichier_sortie_nom); // Message d'erreur
-        fclose(fichier_entree); // Fermer le fichier d'entrée
-        exit(EXIT_FAILURE); // Sortie en cas d'erreur
+        close(fichier_entree); // Fermer le fichier d'entrée
+        return -1;
     }
 
-    initialiser_table(); // Initialiser la table LZW
-    LIRE_CHAR(code); // Lire le premier code
-    ECRIRE_CHAR(code); // Écrire le premier code dans le fichier de sortie
-    dernier_code = code; // Stocker le dernier code
+    struct StatistiquesPipeline mesures;
+    int resultat = -1;
+    const struct DecodeurLZW *decodeur = decodeur_du_fichier(fichier_entree);
+    if (!decodeur) {
+        // Ancien format, sans nombre magique : un seul flux de codes, décodé séquentiellement
+        struct timespec debut, fin;
+        struct CompteurMemoire compteur;
+        long total_codes = 0;
+        compteur_memoire_initialiser(&compteur);
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        FILE *entree = fdopen(fichier_entree, "rb");
+        FILE *sortie = fdopen(fichier_sortie, "wb");
+        if (entree && sortie) {
+            struct CompteurMemoire *precedent = compteur_memoire_attacher(&compteur);
+            resultat = decompresser_ancien_flux_lzw(entree, sortie, &total_codes);
+            compteur_memoire_attacher(precedent);
+        }
+        if (entree) fclose(entree); else close(fichier_entree);
+        if (sortie) fclose(sortie); else close(fichier_sortie);
+        clock_gettime(CLOCK_MONOTONIC, &fin);
 
-    int total_codes = 1; // Compteur pour les codes traités
+        memset(&mesures, 0, sizeof(mesures));
+        mesures.octets_lus = (unsigned long long)total_codes;
+        mesures.nb_travailleurs = 1;
+        mesures.memoire_pic = atomic_load(&compteur.pic);
+        mesures.duree = (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+        mesures.methode_es = "bloquante";
+        struct stat infos;
+        if (resultat == 0 && stat(fichier_sortie_nom, &infos) == 0) {
+            mesures.octets_ecrits = (unsigned long long)infos.st_size;
+        }
+    } else {
+        struct ContexteDecompressionLZW contexte = { decodeur, options->largeur_max };
+        struct ParametresPipeline parametres;
+        parametres_decompression(options, decodeur, &parametres);
+        parametres.traitement = tache_decompression;
+        parametres.contexte = &contexte;
+        resultat = executer_pipeline(fichier_entree, TAILLE_MAGIQUE, fichier_sortie, 0, &parametres, &mesures);
 
-    // Boucle pour lire les codes et décompresser
-    while (LIRE_CHAR(code)) {
-        if (code_absent_dans_table(code)) {
-            dernier_caractere = extraire_chaine(dernier_code); // Extraire la chaîne du dernier code
-            ECRIRE_CHAR(dernier_caractere); // Écrire le caractère dans le fichier de sortie
-        } else {
-            dernier_caractere = extraire_chaine(code); // Extraire la chaîne du code actuel
+        // Fermer les fichiers
+        close(fichier_sortie);
+        close(fichier_entree);
+    }
+
+    if (resultat != 0) {
+        fprintf(stderr, "Échec de la décompression de %s\n", fichier_entree_nom);
+    } else if (stats) {
+        *stats = mesures;
+    }
+    return resultat;
+}
+
+
+/**
+ * Fonction : decompresser_lzw
+ * Description : Décompresse un fichier avec l'algorithme LZW (voir decompresser_fichier_lzw).
+ * Paramètres :
+ * - fichier_entree_nom : Nom du fichier d'entrée à décompresser.
+ * - fichier_sortie_nom : Nom du fichier de sortie où la décompression est écrite.
+ * Retourne : 0 en cas de succès, -1 si le fichier est corrompu.
+ */
+int decompresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom) {
+    struct OptionsLZW options;
+    struct StatistiquesPipeline stats;
+    options_niveau_lzw(LZW_NIVEAU, &options);
+    options.largeur_max = LZW_LARGEUR_MAX; // Tous les fichiers LZW3 sont acceptés
+    int resultat = decompresser_fichier_lzw(fichier_entree_nom, fichier_sortie_nom, &options, &stats);
+
+    if (resultat == 0) {
+        // Octets compressés : tout ce qui suit le nombre magique, sauf les en-têtes et le marqueur de fin
+        // (l'ancien format n'a ni blocs ni marqueur)
+        int par_blocs = 0;
+        int fichier = open(fichier_entree_nom, O_RDONLY);
+        if (fichier >= 0) {
+            par_blocs = decodeur_du_fichier(fichier) != NULL;
+            close(fichier);
         }
-        // Ajouter le nouveau code à la table si elle n'est pas pleine
-        if (table_complete) {
-            ajouter_code(dernier_caractere, dernier_code, prochain_code); // Ajouter le code à la table
-            prochain_code++; // Incrémenter le prochain code
-            if (prochain_code > 255) {
-                table_complete = 0; // La table est pleine
-            }
+        long total_codes = par_blocs ? (long)(stats.octets_lus - (stats.nb_blocs + 1) * sizeof(struct EnTeteBloc))
+                                     : (long)stats.octets_lus;
+
+        // Résumé de la décompression
+        printf("Résumé de la décompression :\n");
+        printf("Total d'octets compressés traités : %ld\n", total_codes); // Afficher le total d'octets traités
+        if (par_blocs) {
+            afficher_statistiques_pipeline(&stats);
         }
-        dernier_code = code; // Mettre à jour le dernier code
-        total_codes++; // Incrémenter le compteur de codes traités
     }
+    return resultat;
+}
 
-    // Fermer les fichiers
-    fclose(fichier_sortie);
-    fclose(fichier_entree);
 
-    // Résumé de la décompression
-    printf("Résumé de la décompression :\n");
-    printf("Total de codes traités : %d\n", total_codes); // Afficher le total de codes traités
+/**
+ * Fonction : verifier_lzw
+ * Description : Vérifie l'intégrité d'un fichier LZW3 ou LZW2 sans le décompresser ni écrire de sortie.
+ * Paramètres :
+ * - fichier_entree_nom : Nom du fichier compressé.
+ * Retourne : 0 si tous les blocs sont intacts, -1 sinon.
+ */
+int verifier_lzw(char *fichier_entree_nom) {
+    // Les deux formats partagent la même structure de blocs, seul le nombre magique change
+    const struct DecodeurLZW *decodeur = &decodeur_lzw3;
+    const char *magique = LZW_MAGIQUE;
+    char magique_lue[TAILLE_MAGIQUE];
+    FILE *fichier = fopen(fichier_entree_nom, "rb");
+    if (fichier) {
+        if (fread(magique_lue, 1, TAILLE_MAGIQUE, fichier) == TAILLE_MAGIQUE &&
+            memcmp(magique_lue, LZW_MAGIQUE_V2, TAILLE_MAGIQUE) == 0) {
+            decodeur = &decodeur_lzw2;
+            magique = LZW_MAGIQUE_V2;
+        }
+        fclose(fichier);
+    }
+    return verifier_fichier_blocs(fichier_entree_nom, magique, LZW_TAILLE_BLOC, taille_compressee_max(decodeur, LZW_TAILLE_BLOC));
 }
-
@@ -9,6 +9,7 @@ void afficher_aide() {
     puts("Utilisation : lzw\n"
          "Appuyez sur 'c' pour compresser un fichier\n"
          "Appuyez sur 'd' pour décompresser un fichier\n"
+         "Appuyez sur 'v' pour vérifier un fichier compressé sans le décompresser\n"
          "Appuyez sur 'h' pour afficher ce message d'aide.");
     exit(EXIT_FAILURE);
 }
@@ -19,7 +20,7 @@ int main() {
     char nom_fichier_sortie[256];
 
     printf("Bienvenue dans le programme de compression LZW !\n");
-    printf("Entrez 'c' pour compresser, 'd' pour décompresser, ou 'h' pour l'aide : ");
+    printf("Entrez 'c' pour compresser, 'd' pour décompresser, 'v' pour vérifier, ou 'h' pour l'aide : ");
     scanf(" %c", &choix); // Espace avant %c pour ignorer les espaces
 
     if (choix == 'h') {
@@ -29,6 +30,11 @@ int main() {
     printf("Veuillez entrer le nom du fichier à traiter : ");
     scanf("%s", nom_fichier); // Lire le nom du fichier
 
+    if (choix == 'v') {
+        // La vérification ne produit aucun fichier de sortie
+        return verifier_lzw(nom_fichier) == 0 ? 0 : EXIT_FAILURE;
+    }
+
     printf("Veuillez entrer le nom du fichier de sortie : ");
     scanf("%s", nom_fichier_sortie); // Lire le nom du fichier de sortie
 
@@ -44,11 +50,15 @@ int main() {
 	} else if (choix == 'd') {
 	    printf("Décompression de %s en %s ... ", nom_fichier, nom_fichier_sortie);
 	    clock_t start = clock();
-	    decompresser_lzw(nom_fichier, nom_fichier_sortie); // Passer les deux noms de fichiers
+	    int resultat = decompresser_lzw(nom_fichier, nom_fichier_sortie); // Passer les deux noms de fichiers
 	    clock_t end = clock();
 
 	    double timeTaken = (double)(end - start) / CLOCKS_PER_SEC;
 	    printf("Temps d'exécution : %.2f secondes\n", timeTaken);
+	    if (resultat != 0) {
+	        printf("échec : fichier corrompu\n");
+	        return EXIT_FAILURE;
+	    }
 	    printf("terminé\n");
 	}
 
@@ -1,16 +1,82 @@
 /* table.h - Fichier d'en-tête pour la définition de la table LZW */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "../commun/bloc.h" // Pour le format des blocs compressés
+#include "../commun/pipeline.h" // Pour les mesures du pipeline
+
+#define LZW_MAGIQUE "LZW3" // Nombre magique du format par blocs (codes de largeur variable)
+#define LZW_MAGIQUE_V2 "LZW2" // Format précédent (codes de 8 bits, ASCII seulement), toujours lisible
+#define LZW_TAILLE_BLOC (1 << 20) // Taille maximale d'un bloc avant compression (1 Mo)
+#define LZW_LONGUEUR_MAX 129 // LZW2 : longueur maximale d'une chaîne, un caractère de base et 128 entrées
+#define LZW_TAMPON_ANCIEN (64 * 1024) // Ancien format (sans nombre magique) : octets lus et écrits à la fois
+
+#define LZW_LARGEUR_MIN 9 // Largeur des codes au début d'un bloc et après une remise à zéro
+#define LZW_LARGEUR_MAX 16 // Plus grande largeur acceptée (dictionnaire de 65536 entrées)
+#define LZW_LARGEUR 13 // Largeur maximale utilisée par compresser_bloc_lzw
+#define LZW_NIVEAU 6 // Niveau par défaut (voir options_niveau_lzw), celui de compresser_bloc_lzw
+#define LZW_ECONOME_TAILLE_BLOC (32 * 1024) // Taille des blocs du mode économe (voir options_econome_lzw)
+#define LZW_CODE_RAZ 256 // Code de remise à zéro du dictionnaire
+#define LZW_PREMIER_CODE 257 // Premier code attribué à une chaîne du dictionnaire
+
+enum PolitiqueLZW {
+    LZW_GEL, // Dictionnaire plein : il n'évolue plus jusqu'à la fin du bloc
+    LZW_RAZ, // Dictionnaire plein : LZW_CODE_RAZ est émis et le dictionnaire repart de zéro
+    LZW_ADAPTATIVE // Dictionnaire plein : figé, puis vidé dès que le taux de compression baisse
+};
+#define LZW_INTERVALLE_CONTROLE 8192 // LZW_ADAPTATIVE : octets lus entre deux mesures du taux
+
+// Paramètres d'un bloc LZW3, au début du corps, avant les codes
+struct ParametresLZW3 {
+    uint8_t largeur_max;    // De LZW_LARGEUR_MIN à LZW_LARGEUR_MAX
+    uint8_t politique;      // enum PolitiqueLZW
+    uint16_t reserve;       // 0
+};
+
+// Borne sur le corps d'un bloc LZW3 de taille octets : au plus un code de 16 bits par octet,
+// et un code de remise à zéro au plus tous les 255 codes
+#define LZW_TAILLE_COMPRESSEE(taille) (sizeof(struct ParametresLZW3) + 2 * (size_t)(taille) + (taille) / 64 + 8)
+
+// Réglages de compression d'un fichier (voir options_niveau_lzw) ; en décompression, taille_bloc et
+// largeur_max sont les limites admises
+struct OptionsLZW {
+    uint32_t taille_bloc;   // Octets par bloc avant compression, au plus LZW_TAILLE_BLOC
+    int largeur_max;
+    int politique;
+    int nb_threads;         // Travailleurs du pipeline, 0 : un par cœur
+    int profondeur;         // Blocs en mémoire au plus, 0 : valeur par défaut du pipeline
+};
 
 struct EntreeLZW {
     unsigned char code_base;
     unsigned char caractere;
 };
 
-/* Macros pour lire et écrire des caractères */
-#define LIRE_CHAR(x) fread(&(x), sizeof(unsigned char), 1, fichier_entree)
-#define ECRIRE_CHAR(x) fwrite(&(x), sizeof(unsigned char), 1, fichier_sortie)
+/* Table LZW d'un bloc LZW2 : chaque décompression a la sienne, sans état global */
+struct TableLZW {
+    struct EntreeLZW entrees[256];
+    int prochain_libre; // Index de la première entrée libre (les entrées sont ajoutées dans l'ordre)
+    int table_complete; // 1 tant que des entrées peuvent être ajoutées, 0 quand la table est pleine
+};
 
 /* Prototypes de fonctions */
-unsigned char extraire_chaine(unsigned char code);
+void initialiser_table(struct TableLZW *table);
+void ajouter_code(struct TableLZW *table, unsigned char caractere, unsigned char code_base, int index_table);
+int extraire_chaine(const struct TableLZW *table, unsigned char code, unsigned char **sortie, const unsigned char *fin);
+unsigned char *compresser_bloc_lzw_avec(const unsigned char *entree, uint32_t taille, int largeur_max, int politique,
+                                        size_t *taille_bloc);
+unsigned char *compresser_bloc_lzw(const unsigned char *entree, uint32_t taille, size_t *taille_bloc);
+int decompresser_bloc_lzw(const struct EnTeteBloc *en_tete, const unsigned char *codes, unsigned char *sortie);
+int compresser_flux_lzw(FILE *fichier_entree, FILE *fichier_sortie, long int *compte_entrees, long int *compte_sorties);
+void options_niveau_lzw(int niveau, struct OptionsLZW *options);
+void options_econome_lzw(struct OptionsLZW *options);
+size_t borne_memoire_compression_lzw(const struct OptionsLZW *options);
+size_t borne_memoire_decompression_lzw(const struct OptionsLZW *options);
+int compresser_fichier_lzw(const char *fichier_entree_nom, const char *fichier_sortie_nom,
+                           const struct OptionsLZW *options, struct StatistiquesPipeline *stats);
 int compresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom); // Prototype mis à jour
-void decompresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom); // Prototype mis à jour
-
+int decompresser_flux_lzw(FILE *fichier_entree, FILE *fichier_sortie, long *total_codes);
+int decompresser_fichier_lzw(const char *fichier_entree_nom, const char *fichier_sortie_nom,
+                             const struct OptionsLZW *options, struct StatistiquesPipeline *stats);
+int decompresser_lzw(char *fichier_entree_nom, char *fichier_sortie_nom); // Retourne -1 si le fichier est corrompu
+int verifier_lzw(char *fichier_entree_nom);
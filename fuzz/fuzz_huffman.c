@@ -0,0 +1,143 @@
+/* fuzz_huffman.c - Cible de fuzzing (style libFuzzer) pour le décodeur et l'encodeur de Huffman */
+#define _GNU_SOURCE // memfd_create
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../Huffman avec interface/huffman.h"
+#include "../commun/memoire.h"
+
+/**
+ * Fonction : decodeWithThreads
+ * Description : Décode un fichier en mémoire avec decompressFileWith, qui n'accepte que des noms de
+ *               fichiers : l'entrée et la sortie sont désignées par /proc/self/fd.
+ * Paramètres :
+ * - inFd : Fichier compressé (memfd).
+ * - threads : Nombre de threads du décodage.
+ * - result : Reçoit le retour de decompressFileWith.
+ * - outputSize : Reçoit la taille de la sortie.
+ * Retourne : La sortie allouée dynamiquement (à libérer avec free), ou NULL en cas d'erreur du harnais.
+ */
+static unsigned char* decodeWithThreads(int inFd, int threads, int* result, size_t* outputSize) {
+    int outFd = memfd_create("fuzz_huffman_sortie", 0);
+    if (outFd < 0) {
+        return NULL;
+    }
+    char inputName[32], outputName[32];
+    snprintf(inputName, sizeof(inputName), "/proc/self/fd/%d", inFd);
+    snprintf(outputName, sizeof(outputName), "/proc/self/fd/%d", outFd);
+    struct HuffmanOptions options;
+    huffmanLevelOptions(6, &options);
+    options.threads = threads;
+    *result = decompressFileWith(inputName, outputName, &options, NULL);
+
+    struct stat st;
+    unsigned char* output = NULL;
+    if (fstat(outFd, &st) == 0) {
+        *outputSize = (size_t)st.st_size;
+        output = malloc(*outputSize + 1);
+        if (output && pread(outFd, output, *outputSize, 0) != (ssize_t)*outputSize) {
+            free(output);
+            output = NULL;
+        }
+    }
+    close(outFd);
+    return output;
+}
+
+/**
+ * Fonction : LLVMFuzzerTestOneInput
+ * Description : Point d'entrée appelé par libFuzzer (ou par fuzz_main.c) pour chaque entrée.
+ *               1. L'entrée est décodée comme un flux compressé (HUF3, HUF2 ou ancien format) :
+ *                  le décodeur doit la rejeter proprement ou la décoder, jamais planter.
+ *               1 bis. Si elle n'a pas de nombre magique, l'entrée est aussi décodée comme un fichier
+ *                  de l'ancien format avec un thread puis avec quatre (décodage par tranches, voir
+ *                  instructions.txt pour des tranches à la taille des entrées) : le retour et la
+ *                  sortie doivent être identiques.
+ *               2. L'entrée est décodée directement comme un bloc (en-tête puis corps), sans
+ *                  passer par le contrôle du CRC de bloc qui arrêterait presque toutes les mutations.
+ *               3. L'entrée est compressée puis décompressée comme un bloc : le résultat doit
+ *                  être identique à l'entrée.
+ * Paramètres :
+ * - data : Octets de l'entrée.
+ * - size : Nombre d'octets.
+ * Retourne : 0 (convention libFuzzer).
+ */
+int LLVMFuzzerTestOneInput(const unsigned char* data, size_t size) {
+    static FILE* sink = NULL;
+    if (!sink) {
+        sink = fopen("/dev/null", "wb");
+    }
+
+    // 1. Décodage d'un flux non fiable
+    if (size > 0) {
+        FILE* in = fmemopen((void*)data, size, "rb");
+        if (in) {
+            decompressStream(in, sink, NULL, NULL, NULL);
+            fclose(in);
+        }
+    }
+
+    // 1 bis. Ancien format : décodage par tranches comparé au décodage séquentiel
+    int freq[256];
+    int symbols = 0;
+    if (size > sizeof(freq) && memcmp(data, HUFFMAN_MAGIC, TAILLE_MAGIQUE) != 0 &&
+        memcmp(data, HUFFMAN_MAGIC_V2, TAILLE_MAGIQUE) != 0) {
+        memcpy(freq, data, sizeof(freq));
+        for (int i = 0; i < 256; i++) {
+            symbols += freq[i] != 0;
+        }
+    }
+    // Avec un seul symbole, la sortie n'est bornée que par la table : rien à découper
+    int inFd = symbols > 1 ? memfd_create("fuzz_huffman_entree", 0) : -1;
+    if (inFd >= 0) {
+        if (write(inFd, data, size) == (ssize_t)size) {
+            int serialResult, parallelResult;
+            size_t serialSize = 0, parallelSize = 0;
+            unsigned char* serial = decodeWithThreads(inFd, 1, &serialResult, &serialSize);
+            unsigned char* parallel = decodeWithThreads(inFd, 4, &parallelResult, &parallelSize);
+            if (serial && parallel && (serialResult != parallelResult || serialSize != parallelSize ||
+                                       memcmp(serial, parallel, serialSize) != 0)) {
+                fprintf(stderr, "Décodage par tranches différent du décodage séquentiel\n");
+                abort();
+            }
+            free(serial);
+            free(parallel);
+        }
+        close(inFd);
+    }
+
+    // 2. Décodage d'un bloc non fiable, CRC de bloc ignoré
+    struct EnTeteBloc header;
+    if (size > sizeof(header)) {
+        memcpy(&header, data, sizeof(header));
+        header.taille_originale %= HUFFMAN_BLOCK_SIZE + 1;
+        header.taille_compressee = (uint32_t)(size - sizeof(header));
+        unsigned char* output = malloc(header.taille_originale + 1);
+        if (output) {
+            decompressBlock(&header, data + sizeof(header), output);
+            free(output);
+        }
+    }
+
+    // 3. Aller-retour compression / décompression
+    if (size > 0 && size <= HUFFMAN_BLOCK_SIZE) {
+        size_t blockSize;
+        unsigned char* block = compressBlock(data, (uint32_t)size, &blockSize);
+        if (!block) {
+            return 0;
+        }
+        memcpy(&header, block, sizeof(header));
+        unsigned char* output = malloc(size);
+        if (!output || decompressBlock(&header, block + sizeof(header), output) != 0 ||
+            memcmp(output, data, size) != 0) {
+            fprintf(stderr, "Aller-retour Huffman incorrect\n");
+            abort();
+        }
+        free(output);
+        memoire_liberer(block);
+    }
+    return 0;
+}
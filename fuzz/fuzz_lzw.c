@@ -0,0 +1,70 @@
+/* fuzz_lzw.c - Cible de fuzzing (style libFuzzer) pour le décodeur et l'encodeur LZW */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../compression lzw/table.h"
+#include "../commun/memoire.h"
+
+/**
+ * Fonction : LLVMFuzzerTestOneInput
+ * Description : Point d'entrée appelé par libFuzzer (ou par fuzz_main.c) pour chaque entrée.
+ *               1. L'entrée est décodée comme un flux LZW3, LZW2 ou de l'ancien format : rejet propre
+ *                  ou décodage, jamais de plantage.
+ *               2. L'entrée est décodée directement comme un bloc LZW3 (en-tête puis corps), sans
+ *                  passer par le contrôle du CRC de bloc qui arrêterait presque toutes les mutations.
+ *               3. L'entrée est compressée puis décompressée comme un bloc, avec une largeur de codes
+ *                  et une politique tirées de ses premiers octets, et le résultat doit être identique.
+ * Paramètres :
+ * - data : Octets de l'entrée.
+ * - size : Nombre d'octets.
+ * Retourne : 0 (convention libFuzzer).
+ */
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size) {
+    static FILE *sink = NULL;
+    if (!sink) {
+        sink = fopen("/dev/null", "wb");
+    }
+
+    // 1. Décodage d'un flux non fiable
+    if (size > 0) {
+        FILE *entree = fmemopen((void *)data, size, "rb");
+        if (entree) {
+            decompresser_flux_lzw(entree, sink, NULL);
+            fclose(entree);
+        }
+    }
+
+    // 2. Décodage d'un bloc non fiable, CRC de bloc ignoré
+    struct EnTeteBloc en_tete;
+    if (size > sizeof(en_tete)) {
+        memcpy(&en_tete, data, sizeof(en_tete));
+        en_tete.taille_originale %= LZW_TAILLE_BLOC + 1;
+        en_tete.taille_compressee = (uint32_t)(size - sizeof(en_tete));
+        unsigned char *sortie = malloc(en_tete.taille_originale + 1);
+        if (sortie) {
+            decompresser_bloc_lzw(&en_tete, data + sizeof(en_tete), sortie);
+            free(sortie);
+        }
+    }
+
+    // 3. Aller-retour compression / décompression, avec tous les réglages possibles
+    if (size > 0 && size <= LZW_TAILLE_BLOC) {
+        size_t taille_bloc;
+        int largeur_max = LZW_LARGEUR_MIN + data[0] % (LZW_LARGEUR_MAX - LZW_LARGEUR_MIN + 1);
+        int politique = data[size - 1] % (LZW_ADAPTATIVE + 1);
+        unsigned char *bloc = compresser_bloc_lzw_avec(data, (uint32_t)size, largeur_max, politique, &taille_bloc);
+        if (!bloc) {
+            return 0;
+        }
+        memcpy(&en_tete, bloc, sizeof(en_tete));
+        unsigned char *sortie = malloc(size);
+        if (!sortie || decompresser_bloc_lzw(&en_tete, bloc + sizeof(en_tete), sortie) != 0 ||
+            memcmp(sortie, data, size) != 0) {
+            fprintf(stderr, "Aller-retour LZW incorrect\n");
+            abort();
+        }
+        free(sortie);
+        memoire_liberer(bloc);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/* fuzz_main.c - Pilote autonome pour les cibles de fuzzing, quand libFuzzer n'est pas disponible (gcc).
+ *
+ * Utilisation :
+ *   ./fuzz_xxx fichier...              rejoue chaque fichier une fois (reproduction d'un plantage)
+ *   ./fuzz_xxx -n N graine [graine...] N mutations aléatoires des fichiers graines
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int LLVMFuzzerTestOneInput(const unsigned char* data, size_t size);
+
+/**
+ * Fonction : lire_fichier
+ * Description : Charge un fichier entier en mémoire.
+ * Paramètres :
+ * - nom : Nom du fichier.
+ * - taille : Reçoit la taille lue.
+ * Retourne : Le contenu alloué dynamiquement, ou NULL en cas d'erreur.
+ */
+static unsigned char* lire_fichier(const char* nom, size_t* taille) {
+    FILE* fichier = fopen(nom, "rb");
+    if (!fichier) {
+        perror(nom);
+        return NULL;
+    }
+    fseek(fichier, 0, SEEK_END);
+    long fin = ftell(fichier);
+    rewind(fichier);
+    unsigned char* donnees = malloc(fin > 0 ? (size_t)fin : 1);
+    *taille = donnees ? fread(donnees, 1, (size_t)(fin > 0 ? fin : 0), fichier) : 0;
+    fclose(fichier);
+    return donnees;
+}
+
+/**
+ * Fonction : muter
+ * Description : Applique quelques mutations aléatoires (inversion de bits, octet aléatoire,
+ *               troncature) à une copie de la graine.
+ * Paramètres :
+ * - graine, taille_graine : Entrée d'origine.
+ * - sortie : Tampon d'au moins taille_graine octets.
+ * Retourne : La taille de l'entrée mutée.
+ */
+static size_t muter(const unsigned char* graine, size_t taille_graine, unsigned char* sortie) {
+    size_t taille = taille_graine;
+    memcpy(sortie, graine, taille);
+    if (taille == 0) {
+        return 0;
+    }
+    int nb_mutations = 1 + rand() % 8;
+    for (int i = 0; i < nb_mutations; i++) {
+        size_t position = (size_t)rand() % taille;
+        switch (rand() % 4) {
+            case 0: sortie[position] ^= (unsigned char)(1 << (rand() % 8)); break;
+            case 1: sortie[position] = (unsigned char)rand(); break;
+            case 2: sortie[position] = (unsigned char)(sortie[position] + 1); break;
+            default: taille = position + 1; break; // Troncature
+        }
+    }
+    return taille;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Utilisation : %s fichier... | -n N graine...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Mode rejeu
+    if (strcmp(argv[1], "-n") != 0) {
+        for (int i = 1; i < argc; i++) {
+            size_t taille;
+            unsigned char* donnees = lire_fichier(argv[i], &taille);
+            if (donnees) {
+                LLVMFuzzerTestOneInput(donnees, taille);
+                free(donnees);
+            }
+        }
+        return 0;
+    }
+
+    // Mode mutation
+    if (argc < 4) {
+        fprintf(stderr, "Utilisation : %s -n N graine...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    long iterations = atol(argv[2]);
+    unsigned seed = (unsigned)time(NULL);
+    srand(seed);
+    fprintf(stderr, "Graine aléatoire : %u\n", seed);
+
+    for (int g = 3; g < argc; g++) {
+        size_t taille_graine;
+        unsigned char* graine = lire_fichier(argv[g], &taille_graine);
+        if (!graine) {
+            continue;
+        }
+        unsigned char* entree = malloc(taille_graine > 0 ? taille_graine : 1);
+        LLVMFuzzerTestOneInput(graine, taille_graine);
+        for (long i = 0; i < iterations; i++) {
+            LLVMFuzzerTestOneInput(entree, muter(graine, taille_graine, entree));
+        }
+        free(entree);
+        free(graine);
+    }
+    return 0;
+}
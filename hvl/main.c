@@ -0,0 +1,383 @@
+/* main.c - Outil en ligne de commande commun aux deux codecs (Huffman et LZW), avec niveaux de compression */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <time.h> // Pour benchmark du temps
+#include "../Huffman avec interface/huffman.h"
+#include "../compression lzw/table.h"
+#include "../commun/crc32c.h"
+
+#define NIVEAU_DEFAUT 6 // HUFFMAN_LEVEL et LZW_NIVEAU
+#define TAILLE_BLOC_MIN 4096
+
+enum Codec { CODEC_HUFFMAN, CODEC_LZW };
+static const char* noms_codecs[] = {"huffman", "lzw"};
+
+// Réglages demandés sur la ligne de commande
+struct Reglages {
+    int codec;
+    int niveau;
+    int nb_threads;         // 0 : un par cœur
+    uint32_t taille_bloc;   // 0 : celle du niveau
+    int details;            // 1 : afficher les mesures du pipeline
+    int econome;            // 1 : mode économe en mémoire, à la place du niveau
+};
+
+void afficher_aide() {
+    puts("Utilisation : hvl [options] fichier [sortie]\n"
+         "  -c              compresser (par défaut) ; sortie : fichier.hvl\n"
+         "  -d              décompresser, codec reconnu au nombre magique ; sortie : fichier sans .hvl\n"
+         "  -t              vérifier un fichier compressé sans le décompresser\n"
+         "  -H, -L          compresser avec Huffman (par défaut) ou avec LZW\n"
+         "  -1 ... -9       niveau, du plus rapide au plus compact (par défaut : -6)\n"
+         "  --threads N     nombre de travailleurs (par défaut : un par processeur)\n"
+         "  --block-size N  taille des blocs avant compression, suffixes k et m acceptés (4k à 1m)\n"
+         "  --low-memory    mode économe : blocs de 32 Ko, petits dictionnaires et tables, un seul\n"
+         "                  travailleur sauf --threads ; la mémoire de travail est bornée et affichée.\n"
+         "                  En décompression, les blocs plus grands que ces réglages sont refusés\n"
+         "  --bench         mesurer le taux et les débits de chaque niveau des deux codecs sur le fichier\n"
+         "  -v              afficher les mesures du pipeline\n"
+         "Entrées et sorties : le fichier à compresser peut être un tube (/dev/stdin), lu dans l'ordre ;\n"
+         "                  le fichier à décompresser, à vérifier ou à mesurer et la sortie ne\n"
+         "                  peuvent pas être des tubes (ils sont lus ou écrits par positions).\n"
+         "Niveaux Huffman : codes de 11 bits (-1 à -3), 12 bits (-4 à -6) ou 15 bits (-7 à -9),\n"
+         "                  blocs de 256 Ko, 512 Ko ou 1 Mo dans chaque groupe.\n"
+         "Niveaux LZW :     codes de 9 à 12 bits vidés dès que le dictionnaire est plein (-1 à -4),\n"
+         "                  puis de 12 à 16 bits vidés quand le taux baisse (-5 à -9).");
+    exit(EXIT_FAILURE);
+}
+
+// Temps réel : clock() additionnerait le temps de tous les threads
+static double maintenant(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/**
+ * Fonction : lire_taille
+ * Description : Convertit une taille écrite en octets, avec un suffixe k ou m facultatif.
+ * Retourne : La taille, ou 0 si le texte n'est pas une taille valide.
+ */
+static uint32_t lire_taille(const char* texte) {
+    char* fin;
+    unsigned long valeur = strtoul(texte, &fin, 10);
+    if (fin == texte) {
+        return 0;
+    }
+    if (*fin == 'k' || *fin == 'K') {
+        valeur <<= 10;
+        fin++;
+    } else if (*fin == 'm' || *fin == 'M') {
+        valeur <<= 20;
+        fin++;
+    }
+    return *fin == '\0' && valeur <= UINT32_MAX ? (uint32_t)valeur : 0;
+}
+
+// Un tube ou une socket ne se lit ni ne s'écrit par positions
+static int est_un_tube(const char* nom) {
+    struct stat infos;
+    return stat(nom, &infos) == 0 && (S_ISFIFO(infos.st_mode) || S_ISSOCK(infos.st_mode));
+}
+
+/**
+ * Fonction : codec_du_fichier
+ * Description : Reconnaît le codec d'un fichier compressé à son nombre magique. Sans nombre magique
+ *               connu, c'est un fichier de l'ancien format : un ancien fichier Huffman si sa table
+ *               des fréquences et sa taille concordent (voir isLegacyFile), un ancien fichier LZW sinon.
+ */
+static int codec_du_fichier(const char* nom) {
+    char magique[TAILLE_MAGIQUE];
+    int lue = 0;
+    FILE* fichier = fopen(nom, "rb");
+    if (fichier) {
+        lue = fread(magique, 1, TAILLE_MAGIQUE, fichier) == TAILLE_MAGIQUE;
+        fclose(fichier);
+    }
+    if (lue && (memcmp(magique, LZW_MAGIQUE, TAILLE_MAGIQUE) == 0 || memcmp(magique, LZW_MAGIQUE_V2, TAILLE_MAGIQUE) == 0)) {
+        return CODEC_LZW;
+    }
+    if (lue && (memcmp(magique, HUFFMAN_MAGIC, TAILLE_MAGIQUE) == 0 || memcmp(magique, HUFFMAN_MAGIC_V2, TAILLE_MAGIQUE) == 0)) {
+        return CODEC_HUFFMAN;
+    }
+    return isLegacyFile(nom) ? CODEC_HUFFMAN : CODEC_LZW;
+}
+
+/**
+ * Fonction : options_lzw
+ * Description : Options LZW des réglages : celles du niveau ou du mode économe, avec le nombre de
+ *               travailleurs et la taille de bloc demandés. En décompression hors mode économe,
+ *               toutes les largeurs de codes sont admises.
+ */
+static void options_lzw(const struct Reglages* reglages, int decompression, struct OptionsLZW* options) {
+    if (reglages->econome) {
+        options_econome_lzw(options);
+    } else {
+        options_niveau_lzw(reglages->niveau, options);
+        if (decompression) {
+            options->taille_bloc = LZW_TAILLE_BLOC;
+            options->largeur_max = LZW_LARGEUR_MAX;
+        }
+    }
+    if (reglages->nb_threads || !reglages->econome) {
+        options->nb_threads = reglages->nb_threads;
+    }
+    if (reglages->taille_bloc) {
+        options->taille_bloc = reglages->taille_bloc;
+    }
+}
+
+// Options Huffman des réglages, voir options_lzw
+static void options_huffman(const struct Reglages* reglages, int decompression, struct HuffmanOptions* options) {
+    if (reglages->econome) {
+        huffmanLowMemoryOptions(options);
+    } else {
+        huffmanLevelOptions(reglages->niveau, options);
+        if (decompression) {
+            options->blockSize = HUFFMAN_BLOCK_SIZE;
+            options->maxCodeLength = HUFFMAN_MAX_CODE_LENGTH;
+        }
+    }
+    if (reglages->nb_threads || !reglages->econome) {
+        options->threads = reglages->nb_threads;
+    }
+    if (reglages->taille_bloc) {
+        options->blockSize = reglages->taille_bloc;
+    }
+}
+
+// Borne sur la mémoire de travail d'une compression ou d'une décompression avec ce codec
+static size_t borne_memoire(const struct Reglages* reglages, int codec, int decompression) {
+    if (codec == CODEC_LZW) {
+        struct OptionsLZW options;
+        options_lzw(reglages, decompression, &options);
+        return decompression ? borne_memoire_decompression_lzw(&options) : borne_memoire_compression_lzw(&options);
+    }
+    struct HuffmanOptions options;
+    options_huffman(reglages, decompression, &options);
+    return decompression ? huffmanDecompressMemoryBound(&options) : huffmanCompressMemoryBound(&options);
+}
+
+/**
+ * Fonction : compresser
+ * Description : Compresse un fichier avec le codec, le niveau et les options demandés.
+ * Paramètres :
+ * - reglages : Réglages de la ligne de commande.
+ * - entree, sortie : Noms des fichiers.
+ * - stats : Reçoit les mesures du pipeline.
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur.
+ */
+static int compresser(const struct Reglages* reglages, const char* entree, const char* sortie,
+                      struct StatistiquesPipeline* stats) {
+    if (reglages->codec == CODEC_LZW) {
+        struct OptionsLZW options;
+        options_lzw(reglages, 0, &options);
+        return compresser_fichier_lzw(entree, sortie, &options, stats);
+    }
+    struct HuffmanOptions options;
+    options_huffman(reglages, 0, &options);
+    return compressFileWith(entree, sortie, &options, stats);
+}
+
+// Décompresse un fichier avec le codec indiqué par son nombre magique
+static int decompresser(const struct Reglages* reglages, const char* entree, const char* sortie,
+                        struct StatistiquesPipeline* stats) {
+    if (codec_du_fichier(entree) == CODEC_LZW) {
+        struct OptionsLZW options;
+        options_lzw(reglages, 1, &options);
+        return decompresser_fichier_lzw(entree, sortie, &options, stats);
+    }
+    struct HuffmanOptions options;
+    options_huffman(reglages, 1, &options);
+    return decompressFileWith(entree, sortie, &options, stats);
+}
+
+/**
+ * Fonction : creer_temporaire
+ * Description : Crée un fichier temporaire vide (dans $TMPDIR, sinon /tmp) et écrit son nom dans nom.
+ * Retourne : 0 en cas de succès, -1 en cas d'erreur.
+ */
+static int creer_temporaire(char* nom, size_t taille) {
+    const char* dossier = getenv("TMPDIR");
+    snprintf(nom, taille, "%s/hvl-XXXXXX", dossier && *dossier ? dossier : "/tmp");
+    int fd = mkstemp(nom);
+    if (fd < 0) {
+        perror("Ne peut pas créer de fichier temporaire");
+        return -1;
+    }
+    close(fd);
+    return 0;
+}
+
+/**
+ * Fonction : banc_essai
+ * Description : Compresse puis décompresse le fichier à chaque niveau des deux codecs, dans des
+ *               fichiers temporaires, et affiche le taux de compression (taille originale sur
+ *               taille compressée), les débits, rapportés à la taille originale, et la mémoire de
+ *               travail au plus fort des deux opérations.
+ * Paramètres :
+ * - reglages : Nombre de travailleurs et taille des blocs (le codec et le niveau sont ignorés).
+ * - entree : Fichier mesuré.
+ * Retourne : 0 si tous les allers-retours réussissent, -1 sinon.
+ */
+static int banc_essai(const struct Reglages* reglages, const char* entree) {
+    char compresse[4096], decompresse[4096];
+    long taille_originale = getFileSize(entree);
+    if (taille_originale < 0) {
+        return -1;
+    }
+    if (creer_temporaire(compresse, sizeof(compresse)) != 0) {
+        return -1;
+    }
+    if (creer_temporaire(decompresse, sizeof(decompresse)) != 0) {
+        remove(compresse);
+        return -1;
+    }
+
+    printf("Banc d'essai sur %s (%ld octets)\n", entree, taille_originale);
+    printf("Niveau  Codec      Taux   Compression   Décompression   Mémoire\n");
+    int resultat = 0;
+    for (int codec = CODEC_HUFFMAN; codec <= CODEC_LZW; codec++) {
+        for (int niveau = 1; niveau <= 9; niveau++) {
+            struct Reglages essai = *reglages;
+            struct StatistiquesPipeline stats;
+            essai.codec = codec;
+            essai.niveau = niveau;
+
+            double debut = maintenant();
+            int echec = compresser(&essai, entree, compresse, &stats) != 0;
+            double duree_compression = maintenant() - debut;
+            long taille_compressee = getFileSize(compresse);
+            size_t memoire = stats.memoire_pic;
+
+            debut = maintenant();
+            echec = echec || decompresser(&essai, compresse, decompresse, &stats) != 0 ||
+                    stats.octets_ecrits != (unsigned long long)taille_originale;
+            double duree_decompression = maintenant() - debut;
+
+            if (echec) {
+                printf("  -%d    %-8s  échec de l'aller-retour\n", niveau, noms_codecs[codec]);
+                resultat = -1;
+                continue;
+            }
+            if (stats.memoire_pic > memoire) {
+                memoire = stats.memoire_pic;
+            }
+            printf("  -%d    %-8s %6.2f  %7.1f Mo/s    %7.1f Mo/s  %7.0f Ko\n", niveau, noms_codecs[codec],
+                   (double)taille_originale / (taille_compressee > 0 ? taille_compressee : 1),
+                   taille_originale / 1e6 / duree_compression, taille_originale / 1e6 / duree_decompression,
+                   memoire / 1024.0);
+            fflush(stdout);
+        }
+    }
+    printf("CRC32C : %s\n", crc32c_implementation());
+
+    remove(compresse);
+    remove(decompresse);
+    return resultat;
+}
+
+int main(int argc, char* argv[]) {
+    struct Reglages reglages = { CODEC_HUFFMAN, NIVEAU_DEFAUT, 0, 0, 0, 0 };
+    char commande = 'c';
+    const char* fichiers[2] = { NULL, NULL };
+    int nb_fichiers = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (strcmp(option, "--threads") == 0 && i + 1 < argc) {
+            reglages.nb_threads = atoi(argv[++i]);
+            if (reglages.nb_threads < 0) {
+                afficher_aide();
+            }
+        } else if (strcmp(option, "--block-size") == 0 && i + 1 < argc) {
+            reglages.taille_bloc = lire_taille(argv[++i]);
+            if (reglages.taille_bloc < TAILLE_BLOC_MIN || reglages.taille_bloc > HUFFMAN_BLOCK_SIZE) {
+                fprintf(stderr, "Taille de bloc invalide : %s\n", argv[i]);
+                afficher_aide();
+            }
+        } else if (strcmp(option, "--low-memory") == 0) {
+            reglages.econome = 1;
+        } else if (strcmp(option, "--bench") == 0) {
+            commande = 'b';
+        } else if (option[0] == '-' && option[1] >= '1' && option[1] <= '9' && option[2] == '\0') {
+            reglages.niveau = option[1] - '0';
+        } else if (strcmp(option, "-c") == 0 || strcmp(option, "-d") == 0 || strcmp(option, "-t") == 0) {
+            commande = option[1];
+        } else if (strcmp(option, "-H") == 0) {
+            reglages.codec = CODEC_HUFFMAN;
+        } else if (strcmp(option, "-L") == 0) {
+            reglages.codec = CODEC_LZW;
+        } else if (strcmp(option, "-v") == 0) {
+            reglages.details = 1;
+        } else if (option[0] == '-' || nb_fichiers == 2) {
+            afficher_aide();
+        } else {
+            fichiers[nb_fichiers++] = option;
+        }
+    }
+    if (nb_fichiers == 0) {
+        afficher_aide();
+    }
+
+    const char* entree = fichiers[0];
+    if (commande != 'c' && est_un_tube(entree)) {
+        fprintf(stderr, "%s : un tube ne peut être que compressé\n", entree);
+        return EXIT_FAILURE;
+    }
+    if (commande == 'b') {
+        return banc_essai(&reglages, entree) == 0 ? 0 : EXIT_FAILURE;
+    }
+    if (commande == 't') {
+        int resultat = codec_du_fichier(entree) == CODEC_LZW ? verifier_lzw((char*)entree) : verifyFile(entree);
+        printf("%s : %s\n", entree, resultat == 0 ? "intact" : "corrompu");
+        return resultat == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    // Nom de sortie par défaut : ajout ou retrait de l'extension .hvl
+    char sortie_defaut[4096];
+    const char* sortie = fichiers[1];
+    if (!sortie) {
+        size_t longueur = strlen(entree);
+        if (commande == 'd' && longueur > 4 && strcmp(entree + longueur - 4, ".hvl") == 0) {
+            snprintf(sortie_defaut, sizeof(sortie_defaut), "%.*s", (int)(longueur - 4), entree);
+        } else {
+            snprintf(sortie_defaut, sizeof(sortie_defaut), "%s%s", entree, commande == 'd' ? ".out" : ".hvl");
+        }
+        sortie = sortie_defaut;
+    }
+    if (est_un_tube(sortie)) {
+        fprintf(stderr, "%s : la sortie ne peut pas être un tube\n", sortie);
+        return EXIT_FAILURE;
+    }
+
+    struct StatistiquesPipeline stats;
+    double debut = maintenant();
+    int resultat = commande == 'd' ? decompresser(&reglages, entree, sortie, &stats)
+                                   : compresser(&reglages, entree, sortie, &stats);
+    double duree = maintenant() - debut;
+    if (resultat != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Un tube compressé n'a pas de taille : on compte les octets lus
+    long taille_entree = commande == 'd' ? getFileSize(entree) : (long)stats.octets_lus;
+    long taille_sortie = getFileSize(sortie);
+    long taille_originale = commande == 'd' ? taille_sortie : taille_entree;
+    long taille_compressee = commande == 'd' ? taille_entree : taille_sortie;
+    printf("%s -> %s : %ld -> %ld octets (taux %.2f), %.1f Mo/s\n", entree, sortie, taille_entree, taille_sortie,
+           (double)taille_originale / (taille_compressee > 0 ? taille_compressee : 1),
+           duree > 0 ? taille_originale / 1e6 / duree : 0.0);
+    if (reglages.econome) {
+        int codec = commande == 'd' ? codec_du_fichier(entree) : reglages.codec;
+        printf("Mémoire de travail : %.1f Ko au plus fort, au plus %.1f Ko\n", stats.memoire_pic / 1024.0,
+               borne_memoire(&reglages, codec, commande == 'd') / 1024.0);
+    }
+    if (reglages.details && stats.nb_blocs > 0) {
+        afficher_statistiques_pipeline(&stats);
+    }
+    return 0;
+}